@@ -33,6 +33,11 @@ class HeaderVector {
 		explicit HeaderVector(StringVector&& vector) : _vector(std::move(vector)) {}
 		virtual ~HeaderVector() = default;
 
+		HeaderVector(const HeaderVector&) = default;
+		HeaderVector(HeaderVector&&) = default;
+		HeaderVector& operator=(const HeaderVector&) = default;
+		HeaderVector& operator=(HeaderVector&&) = default;
+
 		// =========================================================================
 		//  -- Other member functions ----------------------------------------------
 		// =========================================================================
@@ -37,7 +37,7 @@ HttpServer::HttpServer(
 	StreamManager &streamManager,
 	const Properties &properties) :
 	ThreadBase("HTTP Server"),
-	HttpcServer(20, "HTTP", streamManager, properties),
+	HttpcServer(properties.getMaxConnections(), "HTTP", streamManager, properties),
 	_xml(xml) {}
 
 HttpServer::~HttpServer() {
@@ -116,9 +116,9 @@ bool HttpcServer::process(SocketClient &client) {
 //	SI_LOG_DEBUG("@#1 HTML data from client @#2: @#3",
 //		client.getProtocol(), client.getIPAddressOfSocket(), client.getRawMessage());
 
-	// parse HTML
-	const std::string method = client.getMethod();
-	const std::string protocol = client.getProtocol();
+	// The message is parsed once, when it was received
+	const std::string &method = client.getMethod();
+	const std::string_view protocol = client.getRequest().getProtocol();
 	if (method.empty() || protocol.empty()) {
 		SI_LOG_ERROR("Unknown Data: @#1", client.getRawMessage());
 		return false;
@@ -146,25 +146,41 @@ bool HttpcServer::process(SocketClient &client) {
 }
 
 void HttpcServer::processStreamingRequest(SocketClient &client) {
+	// A request can tune, which takes some time. So execute it in order with
+	// the other requests for its Stream and hold the next messages of this
+	// client until it is done
+	if (!holdClient(client)) {
+		executeStreamingRequest(client);
+		return;
+	}
+	const FeIndex feIndex = _streamManager.findFrontendIndexFor(client);
+	_streamManager.dispatchStreamingRequest(feIndex, [this, &client]() {
+		executeStreamingRequest(client);
+		releaseClient(client);
+	});
+}
+
+void HttpcServer::executeStreamingRequest(SocketClient &client) {
 	base::StopWatch sw;
 	sw.start();
 	SI_LOG_DEBUG("@#1 Stream data from client @#2 with IP @#3 on Port @#4: @#5",
 		client.getProtocolString(), "None", client.getIPAddressOfSocket(),
 		client.getSocketPort(), client.getRawMessage());
 
-	HeaderVector headers = client.getHeaders();
-	TransportParamVector params = client.getTransportParameters();
+	// The message is parsed once, when it was received
+	const HttpcRequest &request = client.getRequest();
+	const TransportParamVector &params = request.getTransportParameters();
 
 	// Save clients seq number
-	const std::string fieldCSeq = headers.getFieldParameter("CSeq");
-	const int cseq = fieldCSeq.empty() ? 0 : std::stoi(fieldCSeq);
+	const std::string_view fieldCSeq = request.getHeaderField("CSeq");
+	const int cseq = (!fieldCSeq.empty() && std::isdigit(fieldCSeq[0])) ? std::stoi(std::string(fieldCSeq)) : 0;
 	// Save sessionID and StreamID
-	const std::string sessionID = headers.getFieldParameter("Session");
+	const std::string sessionID(request.getHeaderField("Session"));
 	const StreamID streamID = params.getIntParameter("stream");
 	// Find the FeID with requesed StreamID
 	const auto [feIndex, feID] = _streamManager.findFrontendIDWithStreamID(streamID);
 
-	const std::string method = client.getMethod();
+	const std::string &method = request.getMethod();
 	std::string httpcReply;
 	if (sessionID.empty() && method == "OPTIONS") {
 		static const char* RTSP_OPTIONS_OK =
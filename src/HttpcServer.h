@@ -110,9 +110,12 @@ class HttpcServer :
 		/// Process the data received from @c SocketClient
 		virtual bool process(SocketClient &client) final;
 
-		/// Process the the Method HTTP/RTSP
+		/// Process the the Method HTTP/RTSP, on the request thread of its Stream
 		void processStreamingRequest(SocketClient &client);
 
+		/// Execute the the Method HTTP/RTSP and send the reply
+		void executeStreamingRequest(SocketClient &client);
+
 	private:
 
 		///
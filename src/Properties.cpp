@@ -35,7 +35,8 @@ Properties::Properties(
 		const std::string& ipAddress,
 		const std::string& bindIPAddress,
 		const unsigned int httpPortOpt,
-		const unsigned int rtspPortOpt) :
+		const unsigned int rtspPortOpt,
+		const unsigned int maxConnectionsOpt) :
 	XMLSupport(),
 	_uuid(uuid),
 	_versionString(satpi_version),
@@ -49,6 +50,7 @@ Properties::Properties(
 	_rtspPort = rtspPortOpt == 0 ? 554 : rtspPortOpt;
 	_httpPortOpt = httpPortOpt;
 	_rtspPortOpt = rtspPortOpt;
+	_maxConnections = maxConnectionsOpt == 0 ? MAX_CONNECTIONS_DEFAULT : maxConnectionsOpt;
 	_ipAddress = ipAddress;
 	_bindIPAddress = bindIPAddress;
 
@@ -105,6 +107,7 @@ void Properties::doFromXML(const std::string &xml) {
 void Properties::doAddToXML(std::string &xml) const {
 	ADD_XML_NUMBER_INPUT(xml, "httpport", _httpPort, HTTP_PORT_MIN, TCP_PORT_MAX);
 	ADD_XML_NUMBER_INPUT(xml, "rtspport", _rtspPort, RTSP_PORT_MIN, TCP_PORT_MAX);
+	ADD_XML_ELEMENT(xml, "maxConnections", _maxConnections);
 	ADD_XML_TEXT_INPUT(xml, "ipaddress", _ipAddress);
 	ADD_XML_TEXT_INPUT(xml, "bindipaddress", _bindIPAddress);
 	ADD_XML_TEXT_INPUT(xml, "xsatipm3u", _xSatipM3U);
@@ -177,6 +180,11 @@ unsigned int Properties::getRtspPort() const {
 	return _rtspPort;
 }
 
+unsigned int Properties::getMaxConnections() const {
+	base::MutexLock lock(_mutex);
+	return _maxConnections;
+}
+
 std::string Properties::getIpAddress() const {
 	base::MutexLock lock(_mutex);
 	return _ipAddress;
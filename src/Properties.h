@@ -37,6 +37,9 @@ class Properties :
 		static constexpr unsigned int TCP_PORT_MAX = 65535;
 		static constexpr unsigned int HTTP_PORT_MIN = 1024;
 		static constexpr unsigned int RTSP_PORT_MIN = 554;
+		static constexpr unsigned int MAX_CONNECTIONS_MIN = 1;
+		static constexpr unsigned int MAX_CONNECTIONS_MAX = 4096;
+		static constexpr unsigned int MAX_CONNECTIONS_DEFAULT = 100;
 
 		// =====================================================================
 		// -- Constructors and destructor --------------------------------------
@@ -51,7 +54,8 @@ class Properties :
 			const std::string& ipAddress,
 			const std::string& bindIPAddress,
 			unsigned int httpPortOpt,
-			unsigned int rtspPortOpt);
+			unsigned int rtspPortOpt,
+			unsigned int maxConnectionsOpt);
 
 		virtual ~Properties() = default;
 
@@ -104,6 +108,9 @@ class Properties :
 		/// Get RtspPort
 		unsigned int getRtspPort() const;
 
+		/// Get the maximum amount of connections per HTTP/RTSP server
+		unsigned int getMaxConnections() const;
+
 		/// Get IP Address
 		std::string getIpAddress() const;
 
@@ -147,6 +154,7 @@ class Properties :
 		std::string _appdataPathOpt;
 		unsigned int _httpPortOpt;
 		unsigned int _rtspPortOpt;
+		unsigned int _maxConnections;
 		std::time_t _appStartTime;     // the application start time (EPOCH)
 		mutable bool _exitApplication;
 		mutable bool _restartApplication;
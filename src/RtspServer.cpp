@@ -31,7 +31,7 @@ extern const char* const satpi_version;
 
 RtspServer::RtspServer(StreamManager& streamManager, const Properties& properties) :
 		ThreadBase("RTSP Server"),
-		HttpcServer(20, "RTSP", streamManager, properties) {}
+		HttpcServer(properties.getMaxConnections(), "RTSP", streamManager, properties) {}
 
 RtspServer::~RtspServer() {
 	terminateThread();
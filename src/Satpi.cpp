@@ -34,7 +34,8 @@ SatPI::SatPI(const SatPI::Params &params) :
 	_interface(params.ifaceName),
 	_streamManager(),
 	_properties(_interface.getUUID(), params.currentPath, params.appdataPath, params.webPath,
-		_interface.getIPAddress(), _interface.getBindIPAddress(), params.httpPort, params.rtspPort),
+		_interface.getIPAddress(), _interface.getBindIPAddress(), params.httpPort, params.rtspPort,
+		params.maxConnections),
 	_httpServer(*this, _streamManager, _properties),
 	_rtspServer(_streamManager, _properties),
 	_ssdpServer(params.ssdpTTL, _properties) {
@@ -43,7 +44,8 @@ SatPI::SatPI(const SatPI::Params &params) :
 	//
 	_streamManager.enumerateDevices(_interface.getIPAddress(),
 		_properties.getAppDataPath(), params.dvbPath, params.numberOfChildPIPE,
-		params.enableUnsecureFrontends);
+		params.enableUnsecureFrontends, params.numberOfIOThreads,
+		params.numberOfWriterThreads, params.numberOfDecryptThreads);
 	//
 	std::string xml;
 	if (restoreXML(xml)) {
@@ -59,6 +61,11 @@ SatPI::SatPI(const SatPI::Params &params) :
 	}
 }
 
+SatPI::~SatPI() {
+	// The requests use the servers and their clients, so stop them first
+	_streamManager.stopStreamingRequests();
+}
+
 // =============================================================================
 // -- base::XMLSupport ---------------------------------------------------------
 // =============================================================================
@@ -48,7 +48,11 @@ class SatPI :
 			std::string dvbPath;
 			unsigned int httpPort = 0;
 			unsigned int rtspPort = 0;
+			unsigned int maxConnections = 0;
 			int numberOfChildPIPE = 0;
+			int numberOfIOThreads = 0;
+			int numberOfWriterThreads = 2;
+			int numberOfDecryptThreads = 0;
 			bool enableUnsecureFrontends = false;
 			int ssdpTTL = 1;
 		};
@@ -60,7 +64,7 @@ class SatPI :
 
 		SatPI(const SatPI::Params &params);
 
-		virtual ~SatPI() = default;
+		virtual ~SatPI();
 
 		// =====================================================================
 		// -- base::XMLSupport -------------------------------------------------
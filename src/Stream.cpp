@@ -20,16 +20,20 @@
 #include <Stream.h>
 
 #include <Log.h>
+#include <StreamReactor.h>
 #include <StringConverter.h>
+#include <TransportParamVector.h>
 #include <Utils.h>
 #include <output/StreamClient.h>
 #include <input/Device.h>
 #include <input/dvb/Frontend.h>
 #include <input/dvb/FrontendData.h>
 #include <input/dvb/delivery/DVBS.h>
+#include <mpegts/Filter.h>
 #include <output/StreamClientOutputHttp.h>
 #include <output/StreamClientOutputRtp.h>
 #include <output/StreamClientOutputRtpTcp.h>
+#include <output/StreamClientWriterPool.h>
 #include <socket/SocketClient.h>
 
 #ifdef LIBDVBCSA
@@ -50,6 +54,12 @@ Stream::Stream(input::SpDevice device, decrypt::dvbapi::SpClient decrypt) :
 	_decrypt(decrypt),
 	_device(device),
 	_rtcpSignalUpdate(1),
+	_readBatchSize(DEFAULT_READ_BATCH_SIZE),
+	_sendQueueSize(DEFAULT_SEND_QUEUE_SIZE),
+	_overflowPolicy(asInteger(output::StreamClient::OverflowPolicy::DROP_OLDEST)),
+	_sendChunkSizeKB(DEFAULT_SEND_CHUNK_SIZE_KB),
+	_sendFlushDeadline(DEFAULT_SEND_FLUSH_DEADLINE_MS),
+	_sendZeroCopy(false),
 	_threadDeviceDataReader(
 		StringConverter::stringFormat("Reader@#1", _device->getFeID()),
 		std::bind(&Stream::threadExecuteDeviceDataReader, this)),
@@ -63,6 +73,8 @@ Stream::Stream(input::SpDevice device, decrypt::dvbapi::SpClient decrypt) :
 	ASSERT(device);
 #ifdef LIBDVBCSA
 	ASSERT(decrypt);
+	// Resolve it once, the device stays the same for the lifetime of this stream
+	_decryptInterface = dynamic_cast<input::dvb::FrontendDecryptInterface *>(_device.get());
 #endif
 	// Initialize all TS packets
 	for (mpegts::PacketBuffer& buffer : _tsBuffer) {
@@ -78,6 +90,12 @@ Stream::Stream(input::SpDevice device, decrypt::dvbapi::SpClient decrypt) :
 	_tsEmpty.addAmountOfBytesWritten(188);
 }
 
+Stream::~Stream() {
+	if (_reactor) {
+		_reactor->detach(this);
+	}
+}
+
 // ===========================================================================
 // -- Static member functions ------------------------------------------------
 // ===========================================================================
@@ -96,6 +114,20 @@ void Stream::doAddToXML(std::string &xml) const {
 	ADD_XML_CHECKBOX(xml, "enable", (_enabled ? "true" : "false"));
 	ADD_XML_ELEMENT(xml, "attached", _streamInUse ? "yes" : "no");
 	ADD_XML_NUMBER_INPUT(xml, "rtcpSignalUpdate", _rtcpSignalUpdate, 1, 5);
+	ADD_XML_NUMBER_INPUT(xml, "readBatchSize", _readBatchSize, 1, input::Device::MAX_READ_BATCH_SIZE);
+	ADD_XML_NUMBER_INPUT(xml, "sendQueueSize", _sendQueueSize, 0, MAX_SEND_QUEUE_SIZE);
+	ADD_XML_BEGIN_ELEMENT(xml, "sendQueueOverflow");
+		ADD_XML_ELEMENT(xml, "inputtype", "selectionlist");
+		ADD_XML_ELEMENT(xml, "value", _overflowPolicy);
+		ADD_XML_BEGIN_ELEMENT(xml, "list");
+		ADD_XML_ELEMENT(xml, "option0", "Drop oldest");
+		ADD_XML_ELEMENT(xml, "option1", "Disconnect");
+		ADD_XML_ELEMENT(xml, "option2", "Pause");
+		ADD_XML_END_ELEMENT(xml, "list");
+	ADD_XML_END_ELEMENT(xml, "sendQueueOverflow");
+	ADD_XML_NUMBER_INPUT(xml, "sendChunkSize", _sendChunkSizeKB, 0, MAX_SEND_CHUNK_SIZE_KB);
+	ADD_XML_NUMBER_INPUT(xml, "sendFlushDeadline", _sendFlushDeadline, 0, MAX_SEND_FLUSH_DEADLINE_MS);
+	ADD_XML_CHECKBOX(xml, "sendZeroCopy", (_sendZeroCopy ? "true" : "false"));
 	for (const output::SpStreamClient &client : _streamClientVector) {
 		client->addToXML(xml);
 	}
@@ -110,6 +142,32 @@ void Stream::doFromXML(const std::string &xml) {
 	if (findXMLElement(xml, "rtcpSignalUpdate.value", element)) {
 		_rtcpSignalUpdate = std::stoi(element);
 	}
+	if (findXMLElement(xml, "readBatchSize.value", element)) {
+		const size_t size = std::stoi(element);
+		_readBatchSize = (size >= 1 && size <= input::Device::MAX_READ_BATCH_SIZE) ?
+			size : DEFAULT_READ_BATCH_SIZE;
+	}
+	if (findXMLElement(xml, "sendQueueSize.value", element)) {
+		const size_t size = std::stoi(element);
+		_sendQueueSize = (size <= MAX_SEND_QUEUE_SIZE) ? size : DEFAULT_SEND_QUEUE_SIZE;
+	}
+	if (findXMLElement(xml, "sendQueueOverflow.value", element)) {
+		const int policy = std::stoi(element);
+		_overflowPolicy = (policy >= 0 && policy <= asInteger(output::StreamClient::OverflowPolicy::PAUSE)) ?
+			policy : asInteger(output::StreamClient::OverflowPolicy::DROP_OLDEST);
+	}
+	if (findXMLElement(xml, "sendChunkSize.value", element)) {
+		const size_t size = std::stoi(element);
+		_sendChunkSizeKB = (size <= MAX_SEND_CHUNK_SIZE_KB) ? size : DEFAULT_SEND_CHUNK_SIZE_KB;
+	}
+	if (findXMLElement(xml, "sendFlushDeadline.value", element)) {
+		const unsigned int deadline = std::stoi(element);
+		_sendFlushDeadline = (deadline <= MAX_SEND_FLUSH_DEADLINE_MS) ?
+			deadline : DEFAULT_SEND_FLUSH_DEADLINE_MS;
+	}
+	if (findXMLElement(xml, "sendZeroCopy.value", element)) {
+		_sendZeroCopy = (element == "true") ? true : false;
+	}
 	_device->fromXML(xml);
 }
 
@@ -146,7 +204,39 @@ void Stream::addDeliverySystemCount(
 	}
 }
 
+void Stream::setStreamReactor(SpStreamReactor reactor) {
+	base::MutexLock lock(_mutex);
+	_reactor = reactor;
+	// Remove the device fd from epoll before it is closed, because the fd
+	// number can be reused by an other device meanwhile
+	_device->setCloseDataAvailableFD([this](const int fd) {
+		_reactor->closingFD(this, fd);
+	});
+}
+
+void Stream::setStreamClientWriterPool(output::SpStreamClientWriterPool pool) {
+	base::MutexLock lock(_mutex);
+	_writerPool = pool;
+}
+
+void Stream::setupSendQueue(output::SpStreamClient streamClient) {
+	// Without writer pool the data is written directly by the reader
+	streamClient->setSendQueue(_writerPool ? _sendQueueSize : 0,
+		static_cast<output::StreamClient::OverflowPolicy>(_overflowPolicy),
+		_sendChunkSizeKB * 1024, std::chrono::milliseconds(_sendFlushDeadline));
+	streamClient->setSendZeroCopy(_sendZeroCopy);
+}
+
+bool Stream::useStreamReactor() const {
+	return _reactor && _device->hasDataAvailableFD();
+}
+
+int Stream::getDataAvailableFD() const {
+	return _device->getDataAvailableFD();
+}
+
 void Stream::startStreaming(output::SpStreamClient streamClient) {
+	setupSendQueue(streamClient);
 	streamClient->startStreaming();
 
 	// set begin timestamp
@@ -156,14 +246,28 @@ void Stream::startStreaming(output::SpStreamClient streamClient) {
 	_tsBuffer[_writeIndex].reset();
 
 	_threadDeviceMonitor.startThread();
-	_threadDeviceDataReader.startThread();
-	_threadDeviceDataReader.setPriority(base::Thread::Priority::AboveNormal);
+	if (useStreamReactor()) {
+		_reactor->attach(this);
+	} else {
+		_threadDeviceDataReader.startThread();
+		_threadDeviceDataReader.setPriority(base::Thread::Priority::AboveNormal);
+	}
 	SI_LOG_DEBUG("Frontend: @#1, Start Reader and Monitor Thread", _device->getFeID());
 }
 
 void Stream::pauseStreaming(output::SpStreamClient UNUSED(streamClient)) {
-	_threadDeviceDataReader.pauseThread();
+	if (useStreamReactor()) {
+		_reactor->detach(this);
+	} else {
+		_threadDeviceDataReader.pauseThread();
+	}
 	_threadDeviceMonitor.pauseThread();
+	{
+		base::MutexLock lock(_streamClientMutex);
+		for (const output::SpStreamClient &client : _streamClientVector) {
+			client->clearSendQueue();
+		}
+	}
 	SI_LOG_DEBUG("Frontend: @#1, Pause Reader and Monitor Thread", _device->getFeID());
 #ifdef LIBDVBCSA
 	// When LIBDVBCSA is defined _decrypt is created
@@ -178,13 +282,21 @@ void Stream::restartStreaming(output::SpStreamClient UNUSED(streamClient)) {
 	_readIndex = 0;
 	_tsBuffer[_writeIndex].reset();
 
-	_threadDeviceDataReader.restartThread();
+	if (useStreamReactor()) {
+		_reactor->attach(this);
+	} else {
+		_threadDeviceDataReader.restartThread();
+	}
 	_threadDeviceMonitor.restartThread();
 	SI_LOG_DEBUG("Frontend: @#1, Restart Reader and Monitor Thread", _device->getFeID());
 }
 
 void Stream::stopStreaming() {
-	_threadDeviceDataReader.stopThread();
+	if (useStreamReactor()) {
+		_reactor->detach(this);
+	} else {
+		_threadDeviceDataReader.stopThread();
+	}
 	_threadDeviceMonitor.stopThread();
 	SI_LOG_DEBUG("Frontend: @#1, Stop Reader and Monitor Thread", _device->getFeID());
 #ifdef LIBDVBCSA
@@ -196,10 +308,8 @@ void Stream::stopStreaming() {
 }
 
 void Stream::determineAndMakeStreamClientType(FeID feID, const SocketClient &client) {
-	// Split message into Headers
-	HeaderVector headers = client.getHeaders();
-	const TransportParamVector params = client.getTransportParameters();
-	const std::string method = client.getMethod();
+	const TransportParamVector &params = client.getTransportParameters();
+	const std::string &method = client.getMethod();
 	if (method == "GET") {
 		const std::string multicast = params.getParameter("multicast");
 		if (!multicast.empty()) {
@@ -209,7 +319,6 @@ void Stream::determineAndMakeStreamClientType(FeID feID, const SocketClient &cli
 				client.spoofHeaderWith(StringConverter::stringFormat(
 					"Transport: RTP/AVP;multicast;destination=@#1;port=@#2-@#3;ttl=@#4\r\n",
 					multiParam[0], multiParam[1], multiParam[2], multiParam[3]));
-				headers = client.getHeaders();
 				SI_LOG_INFO("Frontend: @#1, Setup Multicast (@#2) for StreamClient",
 					feID, multicast);
 				SI_LOG_DEBUG("Frontend: @#1, Found Streaming type: HTTP -> Multicast", feID);
@@ -220,7 +329,7 @@ void Stream::determineAndMakeStreamClientType(FeID feID, const SocketClient &cli
 			_streamClientVector.push_back(output::StreamClientOutputHttp::makeSP(feID));
 		}
 	} else {
-		const std::string transport = headers.getFieldParameter("Transport");
+		const std::string_view transport = client.getRequest().getHeaderField("Transport");
 		if (transport.find("unicast") != std::string::npos) {
 			if (transport.find("RTP/AVP") != std::string::npos) {
 				SI_LOG_DEBUG("Frontend: @#1, Found Streaming type: RTP/AVP", feID);
@@ -240,9 +349,11 @@ output::SpStreamClient Stream::findStreamClientFor(SocketClient &socketClient,
 		const bool newSession, const std::string sessionID) {
 	base::MutexLock lock(_mutex);
 	const FeID id = _device->getFeID();
-	const TransportParamVector params = socketClient.getTransportParameters();
+	const TransportParamVector &params = socketClient.getTransportParameters();
 	const input::InputSystem msys = params.getMSYSParameter();
-	const bool shareable = _device->capableToShare(params);
+	// The StreamClients of a shared stream filter their own PIDs from the
+	// send queue, so sharing needs the writer pool
+	const bool shareable = _writerPool && _device->capableToShare(params);
 
 	// Do we have a new session then check some things
 	if (newSession) {
@@ -268,8 +379,12 @@ output::SpStreamClient Stream::findStreamClientFor(SocketClient &socketClient,
 		}
 	}
 
-	// @TODO[StreamClient] Make here StreamClients etc. (add sharing)
 	if (_streamClientVector.empty()) {
+		base::MutexLock clientLock(_streamClientMutex);
+		determineAndMakeStreamClientType(id, socketClient);
+	} else if (newSession && shareable) {
+		SI_LOG_INFO("Frontend: @#1, StreamClient with SessionID @#2 is Sharing...", id, sessionID);
+		base::MutexLock clientLock(_streamClientMutex);
 		determineAndMakeStreamClientType(id, socketClient);
 	}
 
@@ -291,11 +406,6 @@ output::SpStreamClient Stream::findStreamClientFor(SocketClient &socketClient,
 		}
 	}
 
-	if (shareable) {
-		SI_LOG_INFO("Frontend: @#1, StreamClient with SessionID @#2 is Sharing...", id, sessionID);
-		// @TODO: Sharing of devices among StreamClients
-	}
-
 	if (msys != input::InputSystem::UNDEFINED) {
 		SI_LOG_INFO("Frontend: @#1, No StreamClient with SessionID @#2 for @#3",
 			id, sessionID, StringConverter::delsys_to_string(msys));
@@ -305,12 +415,29 @@ output::SpStreamClient Stream::findStreamClientFor(SocketClient &socketClient,
 	return nullptr;
 }
 
+bool Stream::canShareTransponder(const TransportParamVector& params) const {
+	base::MutexLock lock(_mutex);
+	return _enabled && _streamInUse && _writerPool && _device->capableToShare(params);
+}
+
+bool Stream::hasSessionID(const std::string &sessionID) const {
+	base::MutexLock lock(_streamClientMutex);
+	for (const output::SpStreamClient &client : _streamClientVector) {
+		if (client->getSessionID() == sessionID) {
+			return true;
+		}
+	}
+	return false;
+}
+
 void Stream::checkForSessionTimeout() {
 	base::MutexLock lock(_mutex);
 	if (!_streamInUse) {
 		return;
 	}
-	for (const output::SpStreamClient &client : _streamClientVector) {
+	// Use a copy, because teardown removes the StreamClient
+	const std::vector<output::SpStreamClient> clients = _streamClientVector;
+	for (const output::SpStreamClient &client : clients) {
 		if (client->sessionTimeout() || !_enabled) {
 			if (_enabled) {
 				SI_LOG_INFO("Frontend: @#1, Watchdog kicked in for StreamClient with SessionID @#2",
@@ -334,12 +461,16 @@ bool Stream::update(output::SpStreamClient streamClient) {
 		return false;
 	}
 
-	// start or restart streaming again
-	const bool threadStopped = _threadDeviceDataReader.isStopped();
+	// start or restart streaming again (the Monitor thread runs in both reader modes)
+	const bool threadStopped = _threadDeviceMonitor.isStopped();
 	if (threadStopped) {
 		startStreaming(streamClient);
 	} else if (frequencyChanged) {
 		restartStreaming(streamClient);
+	} else if (!streamClient->isStreamActive()) {
+		// This StreamClient is sharing the already running stream
+		setupSendQueue(streamClient);
+		streamClient->startStreaming();
 	}
 	return true;
 }
@@ -350,14 +481,27 @@ bool Stream::teardown(output::SpStreamClient streamClient) {
 	SI_LOG_INFO("Frontend: @#1, Teardown StreamClient with SessionID @#2",
 		_device->getFeID(), streamClient->getSessionID());
 
-	const auto s = std::find(_streamClientVector.begin(), _streamClientVector.end(), streamClient);
-	if (s != _streamClientVector.end()) {
-		_streamClientVector.erase(s);
+	bool lastStreamClient;
+	{
+		base::MutexLock clientLock(_streamClientMutex);
+		const auto s = std::find(_streamClientVector.begin(), _streamClientVector.end(), streamClient);
+		if (s != _streamClientVector.end()) {
+			_streamClientVector.erase(s);
+		}
+		lastStreamClient = _streamClientVector.empty();
 	}
 
 	streamClient->teardown();
-	if (_streamClientVector.size() == 0) {
+	if (_writerPool && streamClient->hasQueuedData()) {
+		// Keep flushing it until the kernel completed the data in flight
+		_writerPool->schedule(streamClient);
+	}
+	if (lastStreamClient) {
 		stopStreaming();
+	} else {
+		// Close the PIDs that are not used by the other StreamClients anymore
+		updateSharedPIDFilter();
+		_device->updatePIDFilters();
 	}
 	return true;
 }
@@ -366,15 +510,32 @@ bool Stream::processStreamingRequest(const SocketClient &client, output::SpStrea
 	base::MutexLock lock(_mutex);
 
 	if (client.hasTransportParameters()) {
-		const std::string method = client.getMethod();
+		const std::string &method = client.getMethod();
 		if (method == "SETUP" || method == "PLAY"  || method == "GET") {
-			const TransportParamVector params = client.getTransportParameters();
-			_device->parseStreamString(params);
+			const TransportParamVector &params = client.getTransportParameters();
+			bool shared;
+			{
+				base::MutexLock clientLock(_streamClientMutex);
+				shared = _streamClientVector.size() > 1;
+			}
+			if (shared && params.getDoubleParameter("freq") != -1.0 &&
+					!_device->capableToShare(params)) {
+				SI_LOG_ERROR("Frontend: @#1, StreamClient with SessionID @#2 requests an other transponder of a shared stream, ignoring...",
+					_device->getFeID(), streamClient->getSessionID());
+			} else if (shared) {
+				// Same transponder, so do not parse it again because that would
+				// reset the PID filters of the other StreamClients
+				updateStreamClientPIDs(streamClient, method, params);
+				updateSharedPIDFilter();
+			} else {
+				_device->parseStreamString(params);
+				updateStreamClientPIDs(streamClient, method, params);
+			}
 		}
 	}
 
 	// Frequency changed?.. pause Stream
-	if (_device->hasDeviceFrequencyChanged() && _threadDeviceDataReader.isStarted()) {
+	if (_device->hasDeviceFrequencyChanged() && _threadDeviceMonitor.isStarted()) {
 		pauseStreaming(streamClient);
 	}
 
@@ -382,6 +543,41 @@ bool Stream::processStreamingRequest(const SocketClient &client, output::SpStrea
 	return true;
 }
 
+void Stream::updateStreamClientPIDs(output::SpStreamClient streamClient,
+		const std::string &method, const TransportParamVector& params) {
+	const FeID id = _device->getFeID();
+	mpegts::Filter &filter = _device->getFilter();
+	mpegts::PidTable::PidSet pids = streamClient->getPIDs();
+	// Same as the device, a query with freq= starts with a new set of PIDs
+	if (params.getDoubleParameter("freq") != -1.0 && (method == "SETUP" || method == "PLAY")) {
+		pids.reset();
+	}
+	const std::string pidsList = params.getParameter("pids");
+	if (!pidsList.empty()) {
+		filter.parsePIDString(id, pidsList, true, pids);
+	}
+	const std::string addpidsList = params.getParameter("addpids");
+	if (!addpidsList.empty()) {
+		filter.parsePIDString(id, addpidsList, true, pids);
+	}
+	const std::string delpidsList = params.getParameter("delpids");
+	if (!delpidsList.empty()) {
+		filter.parsePIDString(id, delpidsList, false, pids);
+	}
+	streamClient->setPIDs(pids);
+}
+
+void Stream::updateSharedPIDFilter() {
+	base::MutexLock lock(_streamClientMutex);
+	const bool shared = _streamClientVector.size() > 1;
+	mpegts::PidTable::PidSet pids;
+	for (const output::SpStreamClient &client : _streamClientVector) {
+		client->setPIDFilter(shared);
+		pids |= client->getPIDs();
+	}
+	_device->getFilter().setPIDs(pids);
+}
+
 std::string Stream::getSDPMediaLevelString() const {
 	_device->monitorSignal(false);
 	const std::string fmtp = _device->attributeDescribeString();
@@ -395,26 +591,84 @@ std::string Stream::getSDPMediaLevelString() const {
 }
 
 bool Stream::threadExecuteDeviceDataReader() {
+	if (!readDeviceData(_device->isDataAvailable())) {
+		// Give the StreamClients some time to send (or complete) the queued
+		// buffers, instead of polling the device over and over again
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return true;
+}
+
+bool Stream::readDeviceData(const bool dataAvailable) {
 	const size_t availableSize = (_writeIndex >= _readIndex) ?
 			((_tsBuffer.size() - _writeIndex) + _readIndex) : (_readIndex - _writeIndex);
 
+	// Keep one buffer free, so a full ring can not be mistaken for an empty one,
+	// and only use the consecutive buffers up until the end of the ring
+	size_t batchSize = std::min({availableSize - 1,
+			_tsBuffer.size() - _writeIndex, _readBatchSize});
+
+	// Buffers that are still in a send queue of a StreamClient or in a decrypt
+	// job (after a restart) can not be used yet
+	bool stalled = false;
+	for (size_t i = 0; i < batchSize; ++i) {
+		if (_tsBuffer[_writeIndex + i].isQueued() || _tsBuffer[_writeIndex + i].isDecrypting()) {
+			stalled = (i == 0);
+			batchSize = i;
+			break;
+		}
+	}
+	// A full buffer here was not reset, because it was still queued
+	if (batchSize >= 1 && _tsBuffer[_writeIndex].full()) {
+		_tsBuffer[_writeIndex].reset();
+	}
+
 //	SI_LOG_DEBUG("Frontend: @#1, PacketBuffer MAX @#2 W @#3 R @#4  A @#5", _device->getFeID(), _tsBuffer.size(), write, read, availableSize);
-	if (_device->isDataAvailable() && availableSize >= 1) {
-		if (_device->readTSPackets(_tsBuffer[_writeIndex])) {
+	if (dataAvailable && batchSize >= 1) {
+		// The first buffer may still have some data from a partial read
+		for (size_t i = 1; i < batchSize; ++i) {
+			_tsBuffer[_writeIndex + i].reset();
+		}
+		const size_t filled = _device->readTSPacketBatch(&_tsBuffer[_writeIndex], batchSize);
 #ifdef LIBDVBCSA
-			// When LIBDVBCSA is defined _decrypt is created
-			_decrypt->decrypt(_device->getFeIndex(), _device->getFeID(), _tsBuffer[_writeIndex]);
+		descrambleDeviceData(_writeIndex, filled, availableSize - filled);
 #endif
-			// goto next, so inc write index
-			++_writeIndex;
-			_writeIndex %= _tsBuffer.size();
-			// reset next
+		// goto next, so inc write index
+		_writeIndex += filled;
+		_writeIndex %= _tsBuffer.size();
+		// reset next, when it is not part of this batch (partial read)
+		if (filled == batchSize && !_tsBuffer[_writeIndex].isQueued()) {
 			_tsBuffer[_writeIndex].reset();
 		}
+	} else {
+#ifdef LIBDVBCSA
+		// Nothing read, but a partial decrypt batch may still wait for its deadline
+		descrambleDeviceData(_writeIndex, 0, availableSize);
+#endif
 	}
 	executeStreamClientWriter();
-	return true;
+	return !(dataAvailable && stalled);
+}
+
+#ifdef LIBDVBCSA
+void Stream::descrambleDeviceData(const std::size_t index, const std::size_t filled,
+		const std::size_t availableSize) {
+	// Only Frontends can decrypt
+	if (_decryptInterface == nullptr) {
+		return;
+	}
+	// When LIBDVBCSA is defined _decrypt is created
+	const FeIndex feIndex = _device->getFeIndex();
+	const FeID feID = _device->getFeID();
+	// The scrambled packets of these buffers are collected in one decrypt batch
+	// over multiple buffers (and reads), it is decrypted when it is full.
+	_decrypt->decrypt(feIndex, feID, *_decryptInterface, &_tsBuffer[index], filled);
+	// A partial batch is decrypted when its deadline passed, or when the ring
+	// is running out of free buffers, because they can not be send before that
+	const bool force = availableSize <= (_readBatchSize * 2);
+	_decrypt->decryptPendingBatch(feID, *_decryptInterface, force);
 }
+#endif
 
 void Stream::executeStreamClientWriter() {
 	// calculate interval
@@ -426,33 +680,54 @@ void Stream::executeStreamClientWriter() {
 			(_writeIndex - _readIndex) : ((_tsBuffer.size() - _readIndex) + _writeIndex);
 
 	if (availableSize > 0 || intervalExeeded) {
-		const size_t cnt = (availableSize > 4) ? 4 : 1;
+		base::MutexLock lock(_streamClientMutex);
+		// Try to keep up with the amount of buffers read in one batch
+		const size_t maxCnt = std::max<size_t>(4, _readBatchSize);
+		const size_t cnt = (availableSize > 4) ? std::min(availableSize, maxCnt) : 1;
 //		SI_LOG_DEBUG("Frontend: @#1, PacketBuffer MAX @#2 W @#3 R @#4 A @#5 C @#6", _device->getFeID(), _tsBuffer.size(), write, read, availableSize, cnt);
 		for (size_t i = 0; i < cnt; ++i) {
 			const bool readyToSend = _tsBuffer[_readIndex].isReadyToSend();
 			if (readyToSend) {
 				_t1 = _t2;
-				bool incrementReadIndex = false;
 				// Send the packet full or not, else send null packet
-				for (const output::SpStreamClient &client : _streamClientVector) {
-					if (client->writeData(_tsBuffer[_readIndex])) {
-						incrementReadIndex = true;
-					}
-				}
-				if (incrementReadIndex) {
+				if (writeToStreamClients(_tsBuffer[_readIndex])) {
 					++_readIndex;
 					_readIndex %= _tsBuffer.size();
 				}
 			} else if (intervalExeeded) {
-				for (const output::SpStreamClient &client : _streamClientVector) {
-					client->writeData(_tsEmpty);
-				}
+				_t1 = _t2;
+				writeToStreamClients(_tsEmpty);
 				break;
 			} else {
 				break;
 			}
 		}
+		// Schedule the clients after queueing, so they can send the buffers in one go
+		if (_writerPool) {
+			for (const output::SpStreamClient &client : _streamClientVector) {
+				if (client->hasQueuedData()) {
+					_writerPool->schedule(client);
+				}
+			}
+		}
+	}
+}
+
+bool Stream::writeToStreamClients(mpegts::PacketBuffer& buffer) {
+	bool handled = false;
+	for (const output::SpStreamClient &client : _streamClientVector) {
+		if (!client->isStreamActive()) {
+			// Not started yet, it is joining a shared stream
+			continue;
+		} else if (client->isSendQueueEnabled()) {
+			// Queued, dropped or paused, the buffer is handled anyway
+			client->queueData(buffer);
+			handled = true;
+		} else if (client->writeData(buffer)) {
+			handled = true;
+		}
 	}
+	return handled;
 }
 
 bool Stream::threadExecuteDeviceMonitor() {
@@ -461,8 +736,13 @@ bool Stream::threadExecuteDeviceMonitor() {
 	const unsigned long interval = 200 * _rtcpSignalUpdate;
 
 	const std::string desc = _device->attributeDescribeString();
-	for (const output::SpStreamClient &client : _streamClientVector) {
-		client->writeRTCPData(desc);
+	{
+		base::MutexLock lock(_streamClientMutex);
+		for (const output::SpStreamClient &client : _streamClientVector) {
+			if (client->isStreamActive()) {
+				client->writeRTCPData(desc);
+			}
+		}
 	}
 	std::this_thread::sleep_for(std::chrono::milliseconds(interval));
 	return true;
@@ -33,9 +33,13 @@
 #include <vector>
 
 FW_DECL_NS0(SocketClient);
+FW_DECL_NS0(TransportParamVector);
+
+FW_DECL_SP_NS0(StreamReactor);
 
 FW_DECL_SP_NS1(input, Device);
 FW_DECL_SP_NS1(output, StreamClient);
+FW_DECL_SP_NS1(output, StreamClientWriterPool);
 FW_DECL_SP_NS2(decrypt, dvbapi, Client);
 FW_DECL_SP_NS2(input, dvb, FrontendDecryptInterface);
 
@@ -53,7 +57,7 @@ class Stream :
 
 		Stream(input::SpDevice device, decrypt::dvbapi::SpClient decrypt);
 
-		virtual ~Stream() = default;
+		virtual ~Stream();
 
 		// =========================================================================
 		// -- static member functions ----------------------------------------------
@@ -101,6 +105,14 @@ class Stream :
 		output::SpStreamClient findStreamClientFor(SocketClient &socketClient,
 				bool newSession, std::string sessionID);
 
+		/// Check if this stream is in use and can share its transponder with
+		/// a new session for the requested parameters
+		bool canShareTransponder(const TransportParamVector& params) const;
+
+		/// Check if this stream has a StreamClient with the requested session,
+		/// without waiting for a request that is using this stream
+		bool hasSessionID(const std::string &sessionID) const;
+
 		/// Check is this stream enabled, can we use it?
 		bool streamEnabled() const {
 			base::MutexLock lock(_mutex);
@@ -115,6 +127,26 @@ class Stream :
 		/// that should be closed
 		void checkForSessionTimeout();
 
+		/// Use the StreamReactor to read the device, instead of the own reader
+		/// thread. Only used for devices that have a file descriptor to wait on.
+		/// @param reactor specifies the StreamReactor to use
+		void setStreamReactor(SpStreamReactor reactor);
+
+		/// Queue the data of the StreamClients and let the writer pool send it,
+		/// instead of writing it from the reader
+		/// @param pool specifies the writer pool to use
+		void setStreamClientWriterPool(output::SpStreamClientWriterPool pool);
+
+		/// Get the device file descriptor to wait on, -1 if there is none (yet)
+		int getDataAvailableFD() const;
+
+		/// Read the device (when data is available) and write it to the
+		/// StreamClients. Called by the reader thread or StreamReactor.
+		/// @param dataAvailable specifies if the device has data to read
+		/// @return false if the data could not be read, because all buffers
+		/// are still in use, so the caller should try again a bit later
+		bool readDeviceData(bool dataAvailable);
+
 	private:
 
 		///
@@ -129,6 +161,9 @@ class Stream :
 		/// Call this when there are no StreamClients using this stream anymore
 		void stopStreaming();
 
+		/// Check if the device of this stream is read by the StreamReactor
+		bool useStreamReactor() const;
+
 		///
 		void determineAndMakeStreamClientType(FeID feID, const SocketClient &client);
 
@@ -136,9 +171,36 @@ class Stream :
 		/// keep thread running and @return false will stop and then terminate this thread
 		bool threadExecuteDeviceDataReader();
 
+#ifdef LIBDVBCSA
+		/// Descramble stage between reading the device and writing to the
+		/// StreamClients, it collects the scrambled packets of the read buffers
+		/// into the decrypt batch and decrypts it when full or too old
+		/// @param index specifies the first buffer that was read
+		/// @param filled specifies the amount of buffers that were read
+		/// @param availableSize specifies the amount of free buffers in the ring
+		void descrambleDeviceData(std::size_t index, std::size_t filled, std::size_t availableSize);
+#endif
+
 		/// Write data to Streamclients
 		void executeStreamClientWriter();
 
+		/// Write or queue the buffer for all Streamclients
+		/// @return true if the buffer is handled by one of the Streamclients
+		bool writeToStreamClients(mpegts::PacketBuffer& buffer);
+
+		/// Setup the send queue of the StreamClient according to the settings
+		/// of this stream
+		void setupSendQueue(output::SpStreamClient streamClient);
+
+		/// Update the PIDs of the StreamClient with the pids/addpids/delpids
+		/// of the request, like the device does for its PID filter
+		void updateStreamClientPIDs(output::SpStreamClient streamClient,
+				const std::string &method, const TransportParamVector& params);
+
+		/// Set the PID filter of the device to the PIDs of all StreamClients,
+		/// and let each StreamClient filter its own PIDs when the stream is shared
+		void updateSharedPIDFilter();
+
 		/// Thread execute function @see base::Thread should @return true to
 		/// keep thread running and @return false will stop and then terminate this thread
 		bool threadExecuteDeviceMonitor();
@@ -167,14 +229,37 @@ class Stream :
 		bool _enabled;
 		bool _streamInUse;
 
+		/// Guards _streamClientVector, because the reader and monitor use it
+		/// while StreamClients are added or removed
+		base::Mutex _streamClientMutex;
 		std::vector<output::SpStreamClient> _streamClientVector;
 
 		decrypt::dvbapi::SpClient _decrypt;
+#ifdef LIBDVBCSA
+		/// The decrypt interface of _device, or nullptr when it can not decrypt
+		input::dvb::FrontendDecryptInterface *_decryptInterface = nullptr;
+#endif
 		input::SpDevice _device;
+		SpStreamReactor _reactor;
+		output::SpStreamClientWriterPool _writerPool;
+		static constexpr std::size_t DEFAULT_SEND_QUEUE_SIZE = 100;
+		static constexpr std::size_t MAX_SEND_QUEUE_SIZE = 200;
+		static constexpr std::size_t DEFAULT_SEND_CHUNK_SIZE_KB = 64;
+		static constexpr std::size_t MAX_SEND_CHUNK_SIZE_KB = 256;
+		static constexpr unsigned int DEFAULT_SEND_FLUSH_DEADLINE_MS = 10;
+		static constexpr unsigned int MAX_SEND_FLUSH_DEADLINE_MS = 200;
+		static constexpr std::size_t DEFAULT_READ_BATCH_SIZE = 16;
+
 		unsigned int _rtcpSignalUpdate;
+		std::size_t _readBatchSize;
+		std::size_t _sendQueueSize;
+		int _overflowPolicy;
+		std::size_t _sendChunkSizeKB;
+		unsigned int _sendFlushDeadline;
+		bool _sendZeroCopy;
 		base::Thread _threadDeviceDataReader;
 		base::Thread _threadDeviceMonitor;
-		std::array<mpegts::PacketBuffer, 100> _tsBuffer;
+		std::array<mpegts::PacketBuffer, 256> _tsBuffer;
 		mpegts::PacketBuffer _tsEmpty;
 		std::size_t _writeIndex;
 		std::size_t _readIndex;
@@ -20,8 +20,11 @@
 #include <StreamManager.h>
 
 #include <Stream.h>
+#include <StreamReactor.h>
+#include <StreamRequestExecutor.h>
 #include <Log.h>
 #include <output/StreamClient.h>
+#include <output/StreamClientWriterPool.h>
 #include <socket/SocketClient.h>
 #include <StringConverter.h>
 #include <input/childpipe/TSReader.h>
@@ -30,6 +33,7 @@
 #include <input/stream/Streamer.h>
 #ifdef LIBDVBCSA
 	#include <decrypt/dvbapi/Client.h>
+	#include <decrypt/dvbapi/DecryptWorkerPool.h>
 	#include <input/dvb/FrontendDecryptInterface.h>
 #endif
 
@@ -44,7 +48,10 @@
 
 StreamManager::StreamManager() :
 	XMLSupport(),
-	_decrypt(nullptr) {
+	_decrypt(nullptr),
+	_reactor(nullptr),
+	_writerPool(nullptr),
+	_requestExecutor(nullptr) {
 #ifdef LIBDVBCSA
 	SI_LOG_INFO("Initializing Decrypt...");
 	_decrypt = std::make_shared<decrypt::dvbapi::Client>(*this);
@@ -63,7 +70,10 @@ void StreamManager::enumerateDevices(
 		const std::string &appDataPath,
 		const std::string &dvbPath,
 		const int numberOfChildPIPE,
-		const bool enableUnsecureFrontends) {
+		const bool enableUnsecureFrontends,
+		const int numberOfIOThreads,
+		const int numberOfWriterThreads,
+		const int numberOfDecryptThreads) {
 #ifdef NOT_PREFERRED_DVB_API
 	SI_LOG_ERROR("Not the preferred DVB API version, for correct function it should be 5.5 or higher");
 #endif
@@ -76,6 +86,39 @@ void StreamManager::enumerateDevices(
 	for (int i = 0; i < numberOfChildPIPE; ++i) {
 		input::childpipe::TSReader::enumerate(_streamVector, appDataPath, _decrypt, enableUnsecureFrontends);
 	}
+
+	// Let the StreamReactor read all streams (that are able to), instead of
+	// one reader thread per stream
+	if (numberOfIOThreads > 0) {
+		_reactor = std::make_shared<StreamReactor>(numberOfIOThreads);
+		for (SpStream stream : _streamVector) {
+			stream->setStreamReactor(_reactor);
+		}
+	}
+
+	// Let the writer pool send the data to the StreamClients, so a slow
+	// client can not stall the reader
+	if (numberOfWriterThreads > 0) {
+		_writerPool = std::make_shared<output::StreamClientWriterPool>(numberOfWriterThreads);
+		for (SpStream stream : _streamVector) {
+			stream->setStreamClientWriterPool(_writerPool);
+		}
+	}
+
+	// Execute the streaming requests per Stream, so a tune does not stall
+	// the servers or the requests for the other Streams
+	_requestExecutor = std::make_shared<StreamRequestExecutor>(_streamVector.size());
+
+	// Let the worker pool decrypt the batches of all frontends, so a busy
+	// frontend is not limited to the core of its reader
+#ifdef LIBDVBCSA
+	if (numberOfDecryptThreads > 0) {
+		_decrypt->setDecryptWorkerPool(
+			std::make_shared<decrypt::dvbapi::DecryptWorkerPool>(numberOfDecryptThreads));
+	}
+#else
+	(void)numberOfDecryptThreads;
+#endif
 }
 
 std::string StreamManager::getXMLDeliveryString() const {
@@ -144,13 +187,12 @@ std::tuple<FeIndex, FeID, StreamID> StreamManager::findFrontendID(const Transpor
 std::tuple<SpStream, output::SpStreamClient>  StreamManager::findStreamAndClientFor(SocketClient &socketClient) {
 	// Here we need to find the correct Stream and StreamClient
 	assert(!_streamVector.empty());
-	HeaderVector headers = socketClient.getHeaders();
-	TransportParamVector params = socketClient.getTransportParameters();
+	const TransportParamVector &params = socketClient.getTransportParameters();
 
 	// Now find index for FrontendID and/or StreamID of this message
 	const auto [feIndex, feID, streamID] = findFrontendID(params);
 
-	std::string sessionID = headers.getFieldParameter("Session");
+	std::string sessionID(socketClient.getRequest().getHeaderField("Session"));
 	bool newSession = false;
 
 	// if no sessionID, then make a new one or its just a outside message.
@@ -173,6 +215,19 @@ std::tuple<SpStream, output::SpStreamClient>  StreamManager::findStreamAndClient
 	if (feIndex == -1) {
 		SI_LOG_INFO("Found FrondtendID: x (fe=x)  StreamID: x  SessionID: @#1  New Session: @#2",
 			sessionID, newSession ? "true" : "false");
+		// Prefer a Stream that is already tuned to the requested transponder
+		if (newSession) {
+			for (SpStream stream : _streamVector) {
+				if (!stream->canShareTransponder(params)) {
+					continue;
+				}
+				output::SpStreamClient streamClient = stream->findStreamClientFor(socketClient, newSession, sessionID);
+				if (streamClient) {
+					streamClient->setSessionID(sessionID);
+					return { stream, streamClient };
+				}
+			}
+		}
 		for (SpStream stream : _streamVector) {
 			output::SpStreamClient streamClient = stream->findStreamClientFor(socketClient, newSession, sessionID);
 			if (streamClient) {
@@ -202,10 +257,49 @@ std::tuple<SpStream, output::SpStreamClient>  StreamManager::findStreamAndClient
 	return { nullptr, nullptr };
 }
 
+FeIndex StreamManager::findFrontendIndexFor(const SocketClient &socketClient) const {
+	const auto [feIndex, feID, streamID] = findFrontendID(socketClient.getTransportParameters());
+	if (feIndex != -1) {
+		return feIndex;
+	}
+	const std::string sessionID(socketClient.getRequest().getHeaderField("Session"));
+	if (!sessionID.empty()) {
+		for (SpStream stream : _streamVector) {
+			if (stream->hasSessionID(sessionID)) {
+				return stream->getFeIndex();
+			}
+		}
+	}
+	return FeIndex();
+}
+
+void StreamManager::dispatchStreamingRequest(const FeIndex feIndex, std::function<void()> job) {
+	if (_requestExecutor) {
+		_requestExecutor->dispatch(feIndex, std::move(job));
+	} else {
+		job();
+	}
+}
+
+void StreamManager::stopStreamingRequests() {
+	if (_requestExecutor) {
+		_requestExecutor->stop();
+	}
+}
+
 void StreamManager::checkForSessionTimeout() {
 	assert(!_streamVector.empty());
 	for (SpStream stream : _streamVector) {
-		stream->checkForSessionTimeout();
+		// Skip the Streams with pending requests, so the checks do not pile
+		// up behind a tune
+		const FeIndex feIndex = stream->getFeIndex();
+		if (!_requestExecutor) {
+			stream->checkForSessionTimeout();
+		} else if (_requestExecutor->getPendingJobs(feIndex) == 0) {
+			_requestExecutor->dispatch(feIndex, [stream]() {
+				stream->checkForSessionTimeout();
+			});
+		}
 	}
 }
 
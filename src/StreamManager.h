@@ -24,15 +24,20 @@
 #include <FwDecl.h>
 #include <base/XMLSupport.h>
 
+#include <functional>
 #include <string>
 #include <tuple>
 
 FW_DECL_NS0(SocketClient);
 FW_DECL_NS0(TransportParamVector);
 
+FW_DECL_SP_NS0(StreamReactor);
+FW_DECL_SP_NS0(StreamRequestExecutor);
+
 FW_DECL_VECTOR_OF_SP_NS0(Stream);
 
 FW_DECL_SP_NS1(output, StreamClient);
+FW_DECL_SP_NS1(output, StreamClientWriterPool);
 FW_DECL_SP_NS2(decrypt, dvbapi, Client);
 FW_DECL_SP_NS2(input, dvb, FrontendDecryptInterface);
 
@@ -70,12 +75,18 @@ class StreamManager :
 		/// @param dvbPath specifies the path were to find dvb devices eg. /dev/dvb
 		/// @param numberOfChildPIPE to enable the requested amount of frontends 'Child PIPE - TS Reader'
 		/// @param enableUnsecureFrontends to enable to use 'Child PIPE - TS Reader' in command directly
+		/// @param numberOfIOThreads the amount of StreamReactor I/O threads, 0 means one reader thread per stream
+		/// @param numberOfWriterThreads the amount of writer threads, 0 means the reader writes to the clients
+		/// @param numberOfDecryptThreads the amount of decrypt worker threads, 0 means the reader decrypts
 		void enumerateDevices(
 			const std::string &bindIPAddress,
 			const std::string &appDataPath,
 			const std::string &dvbPath,
 			int numberOfChildPIPE,
-			bool enableUnsecureFrontends);
+			bool enableUnsecureFrontends,
+			int numberOfIOThreads,
+			int numberOfWriterThreads,
+			int numberOfDecryptThreads);
 
 		///
 		std::tuple<SpStream, output::SpStreamClient> findStreamAndClientFor(SocketClient &socketClient);
@@ -83,9 +94,24 @@ class StreamManager :
 		///
 		std::tuple<FeIndex, FeID> findFrontendIDWithStreamID(StreamID id) const;
 
-		///
+		/// Find the index of the Stream this streaming request is for, without
+		/// waiting for a request that is using a Stream
+		/// @return -1 if it is not known, for instance for a new session
+		FeIndex findFrontendIndexFor(const SocketClient &socketClient) const;
+
+		/// Execute the streaming request in order with the other requests of
+		/// this Stream, on its own request thread
+		/// @param feIndex specifies the Stream, or -1 when it is not known
+		/// @param job specifies the request to execute
+		void dispatchStreamingRequest(FeIndex feIndex, std::function<void()> job);
+
+		/// Check the session time-outs on the request thread of each Stream
 		void checkForSessionTimeout();
 
+		/// Stop executing the streaming requests, call it before the servers
+		/// that dispatch them are destroyed
+		void stopStreamingRequests();
+
 		///
 		std::string getXMLDeliveryString() const;
 
@@ -118,6 +144,9 @@ class StreamManager :
 	private:
 
 		decrypt::dvbapi::SpClient _decrypt;
+		SpStreamReactor _reactor;
+		output::SpStreamClientWriterPool _writerPool;
+		SpStreamRequestExecutor _requestExecutor;
 		StreamSpVector _streamVector;
 };
 
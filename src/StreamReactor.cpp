@@ -0,0 +1,237 @@
+/* StreamReactor.cpp
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <StreamReactor.h>
+
+#include <Log.h>
+#include <Stream.h>
+#include <StringConverter.h>
+#include <Utils.h>
+
+#include <array>
+#include <chrono>
+#include <thread>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+StreamReactor::StreamReactor(const std::size_t numberOfThreads) :
+	_epfd(::epoll_create1(EPOLL_CLOEXEC)),
+	_nextID(0),
+	_deferredCount(0),
+	_lastIdlePass(0) {
+	if (_epfd == -1) {
+		SI_LOG_PERROR("StreamReactor: Failed to create epoll instance");
+		return;
+	}
+	for (std::size_t i = 0; i < numberOfThreads; ++i) {
+		_threads.push_back(std::make_unique<base::Thread>(
+			StringConverter::stringFormat("Reactor@#1", i),
+			std::bind(&StreamReactor::threadExecuteIO, this)));
+		_threads.back()->startThread();
+		_threads.back()->setPriority(base::Thread::Priority::AboveNormal);
+	}
+	SI_LOG_INFO("StreamReactor: Started with @#1 I/O threads", _threads.size());
+}
+
+StreamReactor::~StreamReactor() {
+	// Stop the I/O threads before closing epoll
+	_threads.clear();
+	CLOSE_FD(_epfd);
+}
+
+// =============================================================================
+// -- Other member functions ---------------------------------------------------
+// =============================================================================
+
+void StreamReactor::attach(Stream *stream) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (const auto &[id, entry] : _entries) {
+		if (entry->stream == stream) {
+			return;
+		}
+	}
+	SpEntry entry = std::make_shared<Entry>();
+	entry->stream = stream;
+	entry->id = ++_nextID;
+	_entries.emplace(entry->id, entry);
+	rearm(*entry);
+	SI_LOG_DEBUG("Frontend: @#1, Attached to StreamReactor", stream->getFeID());
+}
+
+void StreamReactor::detach(Stream *stream) {
+	SpEntry entry;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+			if (it->second->stream == stream) {
+				entry = it->second;
+				_entries.erase(it);
+				break;
+			}
+		}
+		if (!entry) {
+			return;
+		}
+		entry->detached = true;
+		setDeferred(*entry, false);
+		if (entry->fd != -1) {
+			::epoll_ctl(_epfd, EPOLL_CTL_DEL, entry->fd, nullptr);
+		}
+		// Wait until the I/O thread that is still reading this stream is done
+		_idleCond.wait(lock, [&entry] { return !entry->busy; });
+	}
+	SI_LOG_DEBUG("Frontend: @#1, Detached from StreamReactor", stream->getFeID());
+}
+
+void StreamReactor::closingFD(Stream *stream, const int fd) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (const auto &[id, entry] : _entries) {
+		if (entry->stream == stream && entry->fd == fd) {
+			::epoll_ctl(_epfd, EPOLL_CTL_DEL, fd, nullptr);
+			entry->fd = -1;
+			return;
+		}
+	}
+}
+
+void StreamReactor::rearm(Entry &entry) {
+	const int fd = entry.stream->getDataAvailableFD();
+	if (fd != entry.fd && entry.fd != -1) {
+		// A closed fd is already removed by closingFD, so this one is still
+		// open and owned by the device
+		::epoll_ctl(_epfd, EPOLL_CTL_DEL, entry.fd, nullptr);
+	}
+	if (fd == -1) {
+		entry.fd = -1;
+		return;
+	}
+	epoll_event ev{};
+	ev.events = EPOLLIN | EPOLLONESHOT;
+	ev.data.u64 = entry.id;
+	const int op = (fd == entry.fd) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+	entry.fd = fd;
+	if (::epoll_ctl(_epfd, op, fd, &ev) == -1) {
+		SI_LOG_PERROR("Frontend: @#1, Failed to add fd: @#2 to StreamReactor",
+			entry.stream->getFeID(), fd);
+	}
+}
+
+void StreamReactor::process(const SpEntry &entry, const bool dataAvailable) {
+	if (entry->busy.exchange(true)) {
+		return;
+	}
+	// Checked after marking it busy, so either detach waits for this read or
+	// this sees that the stream is detached
+	const bool done = entry->detached || entry->stream->readDeviceData(dataAvailable);
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (!entry->detached) {
+			if (done) {
+				setDeferred(*entry, false);
+				rearm(*entry);
+			} else {
+				// The data can not be read yet, and an armed fd would be reported
+				// directly again, so try again later without blocking this thread
+				setDeferred(*entry, true);
+				entry->retry = std::chrono::steady_clock::now() +
+					std::chrono::milliseconds(RETRY_INTERVAL_MS);
+			}
+		}
+		entry->busy = false;
+	}
+	_idleCond.notify_all();
+}
+
+void StreamReactor::setDeferred(Entry &entry, const bool deferred) {
+	if (entry.deferred != deferred) {
+		entry.deferred = deferred;
+		if (deferred) {
+			++_deferredCount;
+		} else {
+			--_deferredCount;
+		}
+	}
+}
+
+std::vector<StreamReactor::SpEntry> StreamReactor::takeDeferred() {
+	std::vector<SpEntry> entries;
+	if (!hasDeferred()) {
+		return entries;
+	}
+	const auto now = std::chrono::steady_clock::now();
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (const auto &[id, entry] : _entries) {
+		if (entry->deferred && entry->retry <= now) {
+			setDeferred(*entry, false);
+			entries.push_back(entry);
+		}
+	}
+	return entries;
+}
+
+bool StreamReactor::threadExecuteIO() {
+	std::array<epoll_event, MAX_EVENTS> events;
+	const int n = ::epoll_wait(_epfd, events.data(), events.size(),
+		hasDeferred() ? RETRY_INTERVAL_MS : IDLE_INTERVAL_MS);
+	if (n == -1 && errno != EINTR) {
+		SI_LOG_PERROR("StreamReactor: epoll_wait failed");
+		std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_INTERVAL_MS));
+		return true;
+	}
+	for (int i = 0; i < n; ++i) {
+		SpEntry entry;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			const auto it = _entries.find(events[i].data.u64);
+			if (it == _entries.end()) {
+				continue;
+			}
+			entry = it->second;
+		}
+		process(entry, true);
+	}
+	for (const SpEntry &entry : takeDeferred()) {
+		process(entry, true);
+	}
+
+	// Every interval one of the I/O threads visits all streams, so the
+	// StreamClients of streams without data still get served and new
+	// device file descriptors are picked up
+	const std::int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+	std::int64_t last = _lastIdlePass;
+	if (now - last >= IDLE_INTERVAL_MS && _lastIdlePass.compare_exchange_strong(last, now)) {
+		std::vector<SpEntry> entries;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			for (const auto &[id, entry] : _entries) {
+				entries.push_back(entry);
+			}
+		}
+		for (const SpEntry &entry : entries) {
+			process(entry, false);
+		}
+	}
+	return true;
+}
@@ -0,0 +1,138 @@
+/* StreamReactor.h
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef STREAM_REACTOR_H_INCLUDE
+#define STREAM_REACTOR_H_INCLUDE STREAM_REACTOR_H_INCLUDE
+
+#include <FwDecl.h>
+#include <base/Thread.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+FW_DECL_NS0(Stream);
+
+FW_DECL_SP_NS0(StreamReactor);
+
+/// The class @c StreamReactor reads the devices of all attached Streams with a
+/// small pool of I/O threads waiting on one epoll instance, instead of one
+/// polling reader thread per Stream.
+class StreamReactor {
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		/// @param numberOfThreads specifies the amount of I/O threads to use
+		explicit StreamReactor(std::size_t numberOfThreads);
+
+		virtual ~StreamReactor();
+
+		StreamReactor(const StreamReactor&) = delete;
+
+		StreamReactor& operator=(const StreamReactor&) = delete;
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Attach the Stream, so its device will be read by the I/O threads
+		/// @param stream specifies the stream to read with @see Stream::readDeviceData
+		void attach(Stream *stream);
+
+		/// Detach the Stream, this will not return while it is being read
+		/// @param stream specifies the stream to detach
+		void detach(Stream *stream);
+
+		/// Remove the device file descriptor of the Stream from epoll, called
+		/// just before the device closes it
+		/// @param stream specifies the stream of the device
+		/// @param fd specifies the file descriptor that will be closed
+		void closingFD(Stream *stream, int fd);
+
+		/// Get the amount of I/O threads
+		std::size_t getNumberOfThreads() const {
+			return _threads.size();
+		}
+
+	private:
+
+		struct Entry {
+			Stream *stream = nullptr;
+			std::uint64_t id = 0;
+			int fd = -1;
+			bool deferred = false;
+			std::chrono::steady_clock::time_point retry;
+			std::atomic_bool busy{false};
+			std::atomic_bool detached{false};
+		};
+		using SpEntry = std::shared_ptr<Entry>;
+
+		/// Thread execute function @see base::Thread should @return true to
+		/// keep thread running and @return false will stop and then terminate this thread
+		bool threadExecuteIO();
+
+		/// Read the stream of this entry, when it is not read by an other I/O thread
+		/// @param dataAvailable specifies if epoll did report data for this entry
+		void process(const SpEntry &entry, bool dataAvailable);
+
+		/// (Re)register the current device file descriptor and arm it for one event
+		void rearm(Entry &entry);
+
+		/// Check if there are entries waiting to be read again
+		bool hasDeferred() const {
+			return _deferredCount > 0;
+		}
+
+		/// Mark the entry as (not) waiting to be read again, @c _mutex should be locked
+		void setDeferred(Entry &entry, bool deferred);
+
+		/// Take the entries that should be read again now
+		std::vector<SpEntry> takeDeferred();
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		static constexpr std::size_t MAX_EVENTS = 32;
+		static constexpr int IDLE_INTERVAL_MS = 100;
+		static constexpr int RETRY_INTERVAL_MS = 1;
+
+		std::mutex _mutex;
+		/// Signaled when an I/O thread is done reading a stream
+		std::condition_variable _idleCond;
+		int _epfd;
+		std::uint64_t _nextID;
+		std::map<std::uint64_t, SpEntry> _entries;
+		/// The amount of deferred entries, so epoll_wait can check it without the lock
+		std::atomic<std::size_t> _deferredCount;
+		std::atomic<std::int64_t> _lastIdlePass;
+		std::vector<std::unique_ptr<base::Thread>> _threads;
+};
+
+#endif // STREAM_REACTOR_H_INCLUDE
@@ -0,0 +1,106 @@
+/* StreamRequestExecutor.cpp
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <StreamRequestExecutor.h>
+
+#include <Log.h>
+#include <StringConverter.h>
+
+#include <chrono>
+
+// =============================================================================
+//  -- Constructors and destructor ---------------------------------------------
+// =============================================================================
+
+StreamRequestExecutor::StreamRequestExecutor(const std::size_t numberOfStreams) {
+	for (std::size_t i = 0; i <= numberOfStreams; ++i) {
+		_lanes.push_back(std::make_unique<Lane>());
+		Lane &lane = *_lanes.back();
+		lane.thread = std::make_unique<base::Thread>(
+			StringConverter::stringFormat("Request@#1", i),
+			std::bind(&StreamRequestExecutor::threadExecuteLane, this, std::ref(lane)));
+		lane.thread->startThread();
+	}
+	SI_LOG_INFO("StreamRequestExecutor: Started with @#1 request threads", _lanes.size());
+}
+
+StreamRequestExecutor::~StreamRequestExecutor() {
+	stop();
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void StreamRequestExecutor::dispatch(const FeIndex feIndex, Job job) {
+	Lane &lane = getLane(feIndex);
+	{
+		std::lock_guard<std::mutex> lock(lane.mutex);
+		if (lane.stopped) {
+			return;
+		}
+		lane.jobs.push_back(std::move(job));
+	}
+	lane.cond.notify_one();
+}
+
+void StreamRequestExecutor::stop() {
+	for (const std::unique_ptr<Lane> &lane : _lanes) {
+		{
+			std::lock_guard<std::mutex> lock(lane->mutex);
+			lane->stopped = true;
+			lane->jobs.clear();
+		}
+		lane->cond.notify_all();
+	}
+	// Destroying the thread waits for the job it is executing
+	for (const std::unique_ptr<Lane> &lane : _lanes) {
+		lane->thread.reset();
+	}
+}
+
+std::size_t StreamRequestExecutor::getPendingJobs(const FeIndex feIndex) const {
+	const Lane &lane = getLane(feIndex);
+	std::lock_guard<std::mutex> lock(lane.mutex);
+	return lane.jobs.size() + (lane.executing ? 1 : 0);
+}
+
+StreamRequestExecutor::Lane &StreamRequestExecutor::getLane(const FeIndex feIndex) const {
+	const std::size_t unknown = _lanes.size() - 1;
+	const std::size_t index = (feIndex >= 0 && static_cast<std::size_t>(feIndex) < unknown) ?
+		static_cast<std::size_t>(feIndex) : unknown;
+	return *_lanes[index];
+}
+
+bool StreamRequestExecutor::threadExecuteLane(Lane &lane) {
+	Job job;
+	{
+		std::unique_lock<std::mutex> lock(lane.mutex);
+		lane.executing = false;
+		if (lane.jobs.empty()) {
+			lane.cond.wait_for(lock, std::chrono::milliseconds(100));
+			return true;
+		}
+		job = std::move(lane.jobs.front());
+		lane.jobs.pop_front();
+		lane.executing = true;
+	}
+	job();
+	return true;
+}
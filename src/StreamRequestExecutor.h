@@ -0,0 +1,102 @@
+/* StreamRequestExecutor.h
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef STREAM_REQUEST_EXECUTOR_H_INCLUDE
+#define STREAM_REQUEST_EXECUTOR_H_INCLUDE STREAM_REQUEST_EXECUTOR_H_INCLUDE
+
+#include <Defs.h>
+#include <FwDecl.h>
+#include <base/Thread.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+FW_DECL_SP_NS0(StreamRequestExecutor);
+
+/// The class @c StreamRequestExecutor executes the streaming requests (which
+/// can tune a frontend) with one thread per Stream. So the requests for
+/// different Streams run in parallel, the requests for the same Stream stay
+/// in order and the server thread does not wait for a tune.
+class StreamRequestExecutor {
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		using Job = std::function<void()>;
+
+		/// @param numberOfStreams specifies the amount of Streams, there is one
+		/// extra lane for requests without a known Stream
+		explicit StreamRequestExecutor(std::size_t numberOfStreams);
+
+		virtual ~StreamRequestExecutor();
+
+		StreamRequestExecutor(const StreamRequestExecutor&) = delete;
+
+		StreamRequestExecutor& operator=(const StreamRequestExecutor&) = delete;
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Execute the job after the jobs already dispatched for this Stream
+		/// @param feIndex specifies the Stream, or -1 when it is not known
+		/// @param job specifies the job to execute
+		void dispatch(FeIndex feIndex, Job job);
+
+		/// Get the amount of jobs that are waiting or executing
+		std::size_t getPendingJobs(FeIndex feIndex) const;
+
+		/// Stop the request threads, this waits for the jobs that are executing
+		/// and drops the waiting (and newly dispatched) ones
+		void stop();
+
+	private:
+
+		struct Lane {
+			mutable std::mutex mutex;
+			std::condition_variable cond;
+			std::deque<Job> jobs;
+			bool executing = false;
+			bool stopped = false;
+			std::unique_ptr<base::Thread> thread;
+		};
+
+		/// Thread execute function @see base::Thread should @return true to
+		/// keep thread running and @return false will stop and then terminate this thread
+		bool threadExecuteLane(Lane &lane);
+
+		/// Get the lane of this Stream, the last lane is for an unknown Stream
+		Lane &getLane(FeIndex feIndex) const;
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		std::vector<std::unique_ptr<Lane>> _lanes;
+};
+
+#endif // STREAM_REQUEST_EXECUTOR_H_INCLUDE
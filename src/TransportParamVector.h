@@ -34,6 +34,11 @@ class TransportParamVector {
 		explicit TransportParamVector(StringVector&& vector) : _vector(std::move(vector)) {}
 		virtual ~TransportParamVector() = default;
 
+		TransportParamVector(const TransportParamVector&) = default;
+		TransportParamVector(TransportParamVector&&) = default;
+		TransportParamVector& operator=(const TransportParamVector&) = default;
+		TransportParamVector& operator=(TransportParamVector&&) = default;
+
 		// =========================================================================
 		//  -- Other member functions ----------------------------------------------
 		// =========================================================================
@@ -0,0 +1,73 @@
+/* LatencyHistogram.cpp
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <base/LatencyHistogram.h>
+
+#include <StringConverter.h>
+#include <base/XMLSupport.h>
+
+namespace base {
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void LatencyHistogram::add(const std::uint64_t ms) noexcept {
+	std::size_t i = 0;
+	while (i < BOUNDS.size() && ms > BOUNDS[i]) {
+		++i;
+	}
+	_buckets[i].fetch_add(1, std::memory_order_relaxed);
+	_count.fetch_add(1, std::memory_order_relaxed);
+	_sum.fetch_add(ms, std::memory_order_relaxed);
+	std::uint64_t max = _max.load(std::memory_order_relaxed);
+	while (ms > max && !_max.compare_exchange_weak(max, ms, std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::clear() noexcept {
+	for (std::atomic<std::uint64_t> &bucket : _buckets) {
+		bucket.store(0, std::memory_order_relaxed);
+	}
+	_count.store(0, std::memory_order_relaxed);
+	_sum.store(0, std::memory_order_relaxed);
+	_max.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::addToXML(std::string &xml, const std::string &name) const {
+	const std::uint64_t count = _count.load(std::memory_order_relaxed);
+	const std::uint64_t sum = _sum.load(std::memory_order_relaxed);
+	std::string buckets;
+	for (std::size_t i = 0; i < NUMBER_OF_BUCKETS; ++i) {
+		if (i < BOUNDS.size()) {
+			buckets += StringConverter::stringFormat("@#1ms:@#2 ", BOUNDS[i],
+				_buckets[i].load(std::memory_order_relaxed));
+		} else {
+			buckets += StringConverter::stringFormat("@#1ms+:@#2", BOUNDS.back(),
+				_buckets[i].load(std::memory_order_relaxed));
+		}
+	}
+	ADD_XML_BEGIN_ELEMENT(xml, name);
+	ADD_XML_ELEMENT(xml, "count", count);
+	ADD_XML_ELEMENT(xml, "avgMS", (count == 0) ? 0 : sum / count);
+	ADD_XML_ELEMENT(xml, "maxMS", _max.load(std::memory_order_relaxed));
+	ADD_XML_ELEMENT(xml, "buckets", buckets);
+	ADD_XML_END_ELEMENT(xml, name);
+}
+
+}
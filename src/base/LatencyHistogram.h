@@ -0,0 +1,79 @@
+/* LatencyHistogram.h
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef BASE_LATENCY_HISTOGRAM_H_INCLUDE
+#define BASE_LATENCY_HISTOGRAM_H_INCLUDE BASE_LATENCY_HISTOGRAM_H_INCLUDE
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace base {
+
+/// The class @c LatencyHistogram counts latencies (in ms) into fixed buckets.
+/// Adding is lock-free, so it can be used in the streaming path.
+class LatencyHistogram {
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		LatencyHistogram() = default;
+
+		virtual ~LatencyHistogram() = default;
+
+		LatencyHistogram(const LatencyHistogram&) = delete;
+
+		LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Add one measured latency
+		void add(std::uint64_t ms) noexcept;
+
+		/// Reset all counters
+		void clear() noexcept;
+
+		/// Add this histogram as element @p name, with count, average, max and
+		/// the buckets as one readable string
+		void addToXML(std::string &xml, const std::string &name) const;
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		/// Upper bound of each bucket in ms, the last bucket counts the rest
+		static constexpr std::array<std::uint64_t, 9> BOUNDS{{5, 10, 25, 50, 100, 250, 500, 1000, 2500}};
+		static constexpr std::size_t NUMBER_OF_BUCKETS = BOUNDS.size() + 1;
+
+		std::array<std::atomic<std::uint64_t>, NUMBER_OF_BUCKETS> _buckets{};
+		std::atomic<std::uint64_t> _count{0};
+		std::atomic<std::uint64_t> _sum{0};
+		std::atomic<std::uint64_t> _max{0};
+};
+
+}
+
+#endif // BASE_LATENCY_HISTOGRAM_H_INCLUDE
@@ -29,8 +29,11 @@
 #include <mpegts/PAT.h>
 #include <mpegts/PMT.h>
 #include <mpegts/SDT.h>
+#include <decrypt/dvbapi/DecryptStatistics.h>
+#include <decrypt/dvbapi/DecryptWorkerPool.h>
 #include <input/dvb/FrontendDecryptInterface.h>
 
+#include <algorithm>
 #include <cstring>
 
 extern "C" {
@@ -90,101 +93,121 @@ namespace decrypt::dvbapi {
 		terminateThread();
 	}
 
-	void Client::decrypt(const FeIndex index, const FeID id, mpegts::PacketBuffer &buffer) {
+	void Client::decrypt(const FeIndex index, const FeID id, input::dvb::FrontendDecryptInterface &frontend,
+			mpegts::PacketBuffer *buffers, const std::size_t count) {
 		if (_connected && _enabled) {
-			const input::dvb::SpFrontendDecryptInterface frontend = _streamManager.getFrontendDecryptInterface(index);
-			const unsigned int maxBatchSize = frontend->getMaximumBatchSize();
-			const std::size_t size = buffer.getNumberOfCompletedPackets();
-			for (std::size_t i = 0; i < size; ++i) {
-				// Get TS packet from the buffer
-				unsigned char *data = buffer.getTSPacketPtr(i);
-
-				// Check is this the beginning of the TS and no Transport error indicator
-				if (data[0] == 0x47 && (data[1] & 0x80) != 0x80) {
-					// get PID from TS
-					const int pid = ((data[1] & 0x1f) << 8) | data[2];
-
-					// this packet scrambled and no NULL packet
-					if (data[3] & 0x80 && pid < 0x1FFF) {
-
-						// scrambled TS packet with even(0) or odd(1) key?
-						const unsigned int parity = (data[3] & 0x40) > 0;
-
-						// get batch parity and count
-						const unsigned int parityBatch = frontend->getBatchParity();
-						const unsigned int countBatch  = frontend->getBatchCount();
-
-						// check if the parity changed in this batch (but should not be the begin of the batch)
-						// or check if this batch full, then decrypt this batch
-						if (countBatch != 0 && (parity != parityBatch || countBatch >= maxBatchSize)) {
-							//
-							SI_LOG_COND_DEBUG(parity != parityBatch, "Frontend: @#1, PID @#2 Parity changed from @#3 to @#4, decrypting batch size @#5",
-								id, PID(pid), parityBatch, parity, countBatch);
-
-							// decrypt this batch
-							frontend->decryptBatch();
-						}
-
-						// Can we add this packet to the batch
-						if (frontend->getKey(parity) != nullptr) {
-							// check is there an adaptation field we should skip.
-							unsigned int skip = 4;
-							if((data[3] & 0x20) && (data[4] < 183)) {
-								skip += data[4] + 1;
-							}
-							// Add it to batch.
-							frontend->setBatchData(data + skip, 188 - skip, parity, data);
+			const unsigned int maxBatchSize = frontend.getMaximumBatchSize();
+			for (std::size_t i = 0; i < count; ++i) {
+				decrypt(index, id, frontend, maxBatchSize, buffers[i]);
+			}
+			if (_sendQueue.hasPending()) {
+				flushSendQueue();
+			}
+		}
+	}
 
-							// set pending decrypt for this buffer
-							buffer.setDecryptPending();
-						} else {
-							// set decrypt failed by setting NULL packet ID..
-							data[1] |= 0x1F;
-							data[2] |= 0xFF;
+	void Client::decrypt(const FeIndex index, const FeID id, input::dvb::FrontendDecryptInterface &frontend,
+			const unsigned int maxBatchSize, mpegts::PacketBuffer &buffer) {
+		const std::size_t size = buffer.getNumberOfCompletedPackets();
+		// Copy it, rewriting TS headers will invalidate the summary
+		const mpegts::PacketSummary summary = buffer.getPacketSummary();
+		const unsigned int validMask = summary.syncMask & ~summary.teiMask;
+		const unsigned int scrambledMask = summary.scrambledMask & ~summary.nullMask;
+		for (std::size_t i = 0; i < size; ++i) {
+			// Get TS packet from the buffer
+			unsigned char *data = buffer.getTSPacketPtr(i);
+			const unsigned int bit = 1 << i;
+
+			// Check is this the beginning of the TS and no Transport error indicator
+			if ((validMask & bit) != 0) {
+				// get PID from TS
+				const int pid = summary.pid[i];
+
+				// this packet scrambled and no NULL packet
+				if ((scrambledMask & bit) != 0) {
+
+					// scrambled TS packet with even(0) or odd(1) key?
+					const unsigned int parity = (summary.oddMask & bit) != 0;
+
+					// get batch parity and count
+					const unsigned int parityBatch = frontend.getBatchParity();
+					const unsigned int countBatch  = frontend.getBatchCount();
+
+					// check if the parity changed in this batch (but should not be the begin of the batch)
+					// or check if this batch full, then decrypt this batch
+					if (countBatch != 0 && (parity != parityBatch || countBatch >= maxBatchSize)) {
+						//
+						SI_LOG_COND_DEBUG(parity != parityBatch, "Frontend: @#1, PID @#2 Parity changed from @#3 to @#4, decrypting batch size @#5",
+							id, PID(pid), parityBatch, parity, countBatch);
+
+						// decrypt this batch
+						frontend.decryptBatch(_workerPool.get());
+					}
 
-							// clear scramble flag, so we can send it.
-							data[3] &= 0x3F;
+					// Can we add this packet to the batch
+					if (frontend.hasKey(parity)) {
+						// check is there an adaptation field we should skip.
+						unsigned int skip = 4;
+						if((data[3] & 0x20) && (data[4] < 183)) {
+							skip += data[4] + 1;
 						}
+						// Add it to batch.
+						frontend.setBatchData(data + skip, 188 - skip, parity, data, buffer);
+
+						// set pending decrypt for this buffer
+						buffer.setDecryptPending();
 					} else {
-						// Need to filter this packet to OSCam
-						unsigned int demux = 0;
-						unsigned int filter = 0;
-						unsigned int tableID = data[5];
-						mpegts::TSData filterData;
-						if (frontend->findOSCamFilterData(pid, data, tableID, filter, demux, filterData)) {
-							// Don't send PAT or PMT before we have an active
-							if (pid == 0 || frontend->isMarkedAsActivePMT(pid)) {
-							} else {
-								const unsigned char* tableData = filterData.data();
-								const int sectionLength = (((tableData[6] & 0x0F) << 8) | tableData[7]) + 3; // 3 = tableID + length field
-								// Check for ICAM in ECM
-								if ((tableID == mpegts::TableData::ECM0_ID ||	tableID == mpegts::TableData::ECM1_ID)) {
-										frontend->setICAM(((tableData[7] - tableData[9]) == 4) ?
-											tableData[26] : 0, ((tableID & 0x01) > 0));
-								}
-								std::unique_ptr<unsigned char[]> clientData(new unsigned char[sectionLength + 25]);
-								const uint32_t request = htonl(DVBAPI_FILTER_DATA);
-								std::memcpy(&clientData[0], &request, 4);
-								clientData[4] =  demux;
-								clientData[5] =  filter;
-								std::memcpy(&clientData[6], &tableData[5], sectionLength); // copy Table data
-								const int length = sectionLength + 6; // 6 = clientData header
-
-								SI_LOG_DEBUG("Frontend: @#1, Send Filter Data with size @#2 for demux: @#3  filter: @#4 PID @#5 TableID @#6 @#7 @#8 @#9 @#10",
-									id, length, demux, filter, PID(pid),
-									HEX2(tableData[5]), HEX2(tableData[6]), HEX2(tableData[7]), HEX2(tableData[8]), HEX2(tableData[9]));
-
-								if (!_client.sendData(clientData.get(), length, MSG_DONTWAIT)) {
-									SI_LOG_ERROR("Frontend: @#1, Filter - send data to server failed", id);
-								}
+						// set decrypt failed by setting NULL packet ID..
+						data[1] |= 0x1F;
+						data[2] |= 0xFF;
+
+						// clear scramble flag, so we can send it.
+						data[3] &= 0x3F;
+						buffer.invalidatePacketSummary();
+						frontend.getDecryptStatistics().packetDropped();
+					}
+				} else {
+					// Need to filter this packet to OSCam
+					unsigned int demux = 0;
+					unsigned int filter = 0;
+					unsigned int tableID = data[5];
+					mpegts::TSData filterData;
+					if (frontend.findOSCamFilterData(pid, data, tableID, filter, demux, filterData)) {
+						// Don't send PAT or PMT before we have an active
+						if (pid == 0 || frontend.isMarkedAsActivePMT(pid)) {
+						} else {
+							const unsigned char* tableData = filterData.data();
+							const int sectionLength = (((tableData[6] & 0x0F) << 8) | tableData[7]) + 3; // 3 = tableID + length field
+							// Check for ICAM in ECM
+							const bool ecm = (tableID == mpegts::TableData::ECM0_ID || tableID == mpegts::TableData::ECM1_ID);
+							if (ecm) {
+									frontend.setICAM(((tableData[7] - tableData[9]) == 4) ?
+										tableData[26] : 0, ((tableID & 0x01) > 0));
+									frontend.getDecryptStatistics().ecmSeen();
 							}
+							unsigned char clientData[MAX_FILTER_DATA_SIZE];
+							const uint32_t request = htonl(DVBAPI_FILTER_DATA);
+							std::memcpy(&clientData[0], &request, 4);
+							clientData[4] =  demux;
+							clientData[5] =  filter;
+							std::memcpy(&clientData[6], &tableData[5], sectionLength); // copy Table data
+							const int length = sectionLength + 6; // 6 = clientData header
+
+							SI_LOG_DEBUG("Frontend: @#1, Send Filter Data with size @#2 for demux: @#3  filter: @#4 PID @#5 TableID @#6 @#7 @#8 @#9 @#10",
+								id, length, demux, filter, PID(pid),
+								HEX2(tableData[5]), HEX2(tableData[6]), HEX2(tableData[7]), HEX2(tableData[8]), HEX2(tableData[9]));
+
+							// Queue it, all queued messages are send after this run of buffers.
+							// The ECM is counted as send when it is written to OSCam
+							_sendQueue.push(clientData, length,
+								ecm ? &frontend.getDecryptStatistics() : nullptr);
 						}
+					}
 
-						if (frontend->isMarkedAsActivePMT(pid)) {
-							sendPMT(index, id, *frontend->getSDTData(), *frontend->getPMTData(pid));
-							if (_rewritePMT) {
-								mpegts::PMT::cleanPI(data);
-							}
+					if (frontend.isMarkedAsActivePMT(pid)) {
+						sendPMT(index, id, *frontend.getSDTData(), *frontend.getPMTData(pid));
+						if (_rewritePMT) {
+							mpegts::PMT::cleanPI(data);
 						}
 					}
 				}
@@ -192,6 +215,14 @@ namespace decrypt::dvbapi {
 		}
 	}
 
+	void Client::decryptPendingBatch(const FeID id, input::dvb::FrontendDecryptInterface &frontend, const bool force) {
+		const unsigned int countBatch = frontend.getBatchCount();
+		if (countBatch != 0 && (force || frontend.isBatchDeadlineExpired())) {
+			SI_LOG_COND_DEBUG(force, "Frontend: @#1, Forced decrypting partial batch size @#2", id, countBatch);
+			frontend.decryptBatch(_workerPool.get());
+		}
+	}
+
 	bool Client::stopDecrypt(const FeIndex index, const FeID id) {
 		const input::dvb::SpFrontendDecryptInterface frontend = _streamManager.getFrontendDecryptInterface(index);
 		if (_connected) {
@@ -205,10 +236,11 @@ namespace decrypt::dvbapi {
 			buff[6] = 0x00;
 			buff[7] = demux;
 			SI_LOG_DEBUG("Frontend: @#1, Stop CA Decrypt with demux index @#2", id, demux);
-			if (!_client.sendData(buff, sizeof(buff), MSG_DONTWAIT)) {
+			if (!_sendQueue.push(buff, sizeof(buff))) {
 				SI_LOG_ERROR("Frontend: @#1, Stop CA Decrypt with demux index @#2 - send data to server failed", id, demux);
 				return false;
 			}
+			flushSendQueue();
 		}
 		// Remove this PMT from the list
 		const auto it = _capmtMap.find(index.getID());
@@ -242,8 +274,8 @@ namespace decrypt::dvbapi {
 		std::string name = "SatPI ";
 		name += satpi_version;
 
-		const int len = name.size() - 1; // ignoring null termination
-		std::unique_ptr<unsigned char[]> buff(new unsigned char[7 + len]);
+		const int len = std::min<int>(name.size() - 1, 255); // ignoring null termination
+		unsigned char buff[7 + 255];
 
 		const uint32_t request = htonl(DVBAPI_CLIENT_INFO);
 		std::memcpy(&buff[0], &request, 4);
@@ -254,9 +286,8 @@ namespace decrypt::dvbapi {
 		buff[6] = len;
 		std::memcpy(&buff[7], name.data(), len);
 
-		if (!_client.sendData(buff.get(), 7 + len, MSG_DONTWAIT)) {
-			SI_LOG_ERROR("write failed");
-		}
+		_sendQueue.push(buff, 7 + len);
+		flushSendQueue();
 	}
 
 	void Client::sendPMT(const FeIndex index, const FeID id, const mpegts::SDT &sdt, const mpegts::PMT &pmt) {
@@ -359,7 +390,8 @@ namespace decrypt::dvbapi {
 					id, static_cast<int>(entry.caPtr[16]), static_cast<int>(entry.caPtr[15]), HEX2(entry.caPtr[6]));
 			}
 
-			if (!_client.sendData(entry.caPtr.get(), entry.size, MSG_DONTWAIT)) {
+			// Queue it, the list is send in one go
+			if (!_sendQueue.push(entry.caPtr.get(), entry.size)) {
 				SI_LOG_ERROR("Frontend: @#1, PMT - send data to server failed", id);
 			}
 		}
@@ -369,6 +401,7 @@ namespace decrypt::dvbapi {
 		SI_LOG_INFO("Setting up DVBAPI client");
 
 		struct pollfd pfd[1];
+		pfd[0].fd = -1;
 
 		// set time to try to connect
 		std::time_t retryTime = std::time(nullptr) + 2;
@@ -376,13 +409,13 @@ namespace decrypt::dvbapi {
 		while (running()) {
 			// try to connect to server
 			if (!_connected) {
-				pfd[0].events  = POLLIN | POLLHUP | POLLRDNORM | POLLERR;
-				pfd[0].revents = 0;
-				pfd[0].fd      = -1;
+				pfd[0].fd = -1;
 				if (_enabled) {
 					const std::time_t currTime = std::time(nullptr);
 					if (retryTime < currTime) {
 						if (initClientSocket(_client, _serverIPAddr, _serverPort)) {
+							_receiveBuffer.clear();
+							_sendQueue.clear();
 							sendClientInfo();
 							pfd[0].fd = _client.getFD();
 						} else {
@@ -392,136 +425,201 @@ namespace decrypt::dvbapi {
 					}
 				}
 			}
+			// Also wait until we can send, when there are queued messages left
+			pfd[0].events  = POLLIN | POLLHUP | POLLRDNORM | POLLERR;
+			pfd[0].events |= _sendQueue.hasPending() ? POLLOUT : 0;
+			pfd[0].revents = 0;
 			// call poll with a timeout of 500 ms
 			const int pollRet = poll(pfd, 1, 500);
-			if (pollRet > 0) {
-				if (pfd[0].revents != 0) {
-					char tmpData[2048];
-					auto i = 0;
-					const ssize_t size = _client.recvDatafrom(tmpData, sizeof(tmpData) - 1, MSG_DONTWAIT);
-					const unsigned char* buf = reinterpret_cast<unsigned char *>(&tmpData);
-					if (size > 0) {
-						while (i < size) {
-							// get command
-							const uint32_t cmd = (buf[i + 0] << 24) | (buf[i + 1] << 16) | (buf[i + 2] << 8) | buf[i + 3];
-//							SI_LOG_DEBUG("Frontend: @#1, Receive data total size @#2 - cmd: @#3", buf[i + 4] - _adapterOffset, size, HEX2(cmd));
-
-							switch (cmd) {
-								case DVBAPI_SERVER_INFO: {
-										_serverName.assign(reinterpret_cast<const char *>(&buf[i + 7]), buf[i + 6]);
-										SI_LOG_INFO("Connected to @#1", _serverName);
-										_connected = true;
-
-										// Goto next cmd
-										i += 7 + _serverName.size();
-										break;
-									}
-								case DVBAPI_DMX_SET_FILTER: {
-										const int adapter =  buf[i + 4] - _adapterOffset;
-										const int demux   =  buf[i + 5];
-										const int filter  =  buf[i + 6];
-										const int pid     = (buf[i + 7] << 8) | buf[i + 8];
-										const unsigned char* filterData = &buf[i + 9];
-										const unsigned char* filterMask = &buf[i + 25];
-
-//										SI_LOG_BIN_DEBUG(&buf[i], 65, "Frontend: @#1, DVBAPI_DMX_SET_FILTER", adapter);
-
-										const input::dvb::SpFrontendDecryptInterface frontend = _streamManager.getFrontendDecryptInterface(adapter);
-										frontend->startOSCamFilterData(pid, demux, filter, filterData, filterMask);
-
-										// Goto next cmd
-										i += 65;
-										break;
-									}
-								case DVBAPI_DMX_STOP: {
-										const int adapter =  buf[i + 4] - _adapterOffset;
-										const int demux   =  buf[i + 5];
-										const int filter  =  buf[i + 6];
-										const int pid     = (buf[i + 7] << 8) | buf[i + 8];
-
-										const input::dvb::SpFrontendDecryptInterface frontend = _streamManager.getFrontendDecryptInterface(adapter);
-										frontend->stopOSCamFilterData(pid, demux, filter);
-
-										// Goto next cmd
-										i += 9;
-										break;
-									}
-								case DVBAPI_CA_SET_DESCR: {
-										const int adapter =  buf[i + 4] - _adapterOffset;
-										const int index   = (buf[i + 5] << 24) | (buf[i +  6] << 16) | (buf[i +  7] << 8) | buf[i +  8];
-										const int parity  = (buf[i + 9] << 24) | (buf[i + 10] << 16) | (buf[i + 11] << 8) | buf[i + 12];
-										unsigned char cw[9];
-										memcpy(cw, &buf[i + 13], 8);
-										cw[8] = 0;
-
-										const input::dvb::SpFrontendDecryptInterface frontend = _streamManager.getFrontendDecryptInterface(adapter);
-										frontend->setKey(cw, parity, index);
-										SI_LOG_DEBUG("Frontend: @#1, Received @#2(@#3) CW: @#4 @#5 @#6 @#7 @#8 @#9 @#10 @#11  index: @#12",
-											frontend->getFeID(), (parity == 0) ? "even" : "odd", HEX2(parity),
-											HEX2(cw[0]), HEX2(cw[1]), HEX2(cw[2]), HEX2(cw[3]),
-											HEX2(cw[4]), HEX2(cw[5]), HEX2(cw[6]), HEX2(cw[7]), index);
-
-										// Goto next cmd
-										i += 21;
-										break;
-									}
-								case DVBAPI_CA_SET_PID: {
-//										const int adapter   =  buf[i +  4] - _adapterOffset;
-//										SI_LOG_BIN_DEBUG(&buf[i], 65, "Frontend: @#1, DVBAPI_CA_SET_PID", adapter);
-
-										// Goto next cmd
-										i += 13;
-										break;
-									}
-								case DVBAPI_ECM_INFO: {
-										const int adapter   =  buf[i +  4] - _adapterOffset;
-										const int serviceID = (buf[i +  5] <<  8) |  buf[i +  6];
-										const int caID      = (buf[i +  7] <<  8) |  buf[i +  8];
-										const int pid       = (buf[i +  9] <<  8) |  buf[i + 10];
-										const int provID    = (buf[i + 11] << 24) | (buf[i + 12] << 16) | (buf[i + 13] << 8) | buf[i + 14];
-										const int emcTime   = (buf[i + 15] << 24) | (buf[i + 16] << 16) | (buf[i + 17] << 8) | buf[i + 18];
-										i += 19;
-										std::string cardSystem;
-										cardSystem.assign(reinterpret_cast<const char *>(&buf[i + 1]), buf[i + 0]);
-										i += buf[i + 0] + 1;
-										std::string readerName;
-										readerName.assign(reinterpret_cast<const char *>(&buf[i + 1]), buf[i + 0]);
-										i += buf[i + 0] + 1;
-										std::string sourceName;
-										sourceName.assign(reinterpret_cast<const char *>(&buf[i + 1]), buf[i + 0]);
-										i += buf[i + 0] + 1;
-										std::string protocolName;
-										protocolName.assign(reinterpret_cast<const char *>(&buf[i + 1]), buf[i + 0]);
-										i += buf[i + 0] + 1;
-										const int hops = buf[i];
-										++i;
-
-										const input::dvb::SpFrontendDecryptInterface frontend = _streamManager.getFrontendDecryptInterface(adapter);
-										frontend->setECMInfo(pid, serviceID, caID, provID, emcTime,
-														  cardSystem, readerName, sourceName, protocolName, hops);
-										SI_LOG_DEBUG("Frontend: @#1, Receive ECM Info System: @#2  Reader: @#3  Source: @#4  Protocol: @#5  ECM Time: @#6",
-											frontend->getFeID(), cardSystem, readerName, sourceName, protocolName, emcTime);
-										break;
-									}
-								default:
-									SI_LOG_BIN_DEBUG(buf, size, "Frontend: x, Receive unexpected data");
-									i = size;
-									break;
-							}
-						}
-					} else {
-						// connection closed, try to reconnect
-						SI_LOG_INFO("Connection lost with @#1", _serverName);
-						_serverName = "Not connected";
-						_client.closeFD();
-						pfd[0].fd = -1;
-						_connected = false;
+			if (pollRet <= 0 || pfd[0].revents == 0) {
+				continue;
+			}
+			if ((pfd[0].revents & POLLOUT) != 0) {
+				flushSendQueue();
+			}
+			if ((pfd[0].revents & ~POLLOUT) == 0) {
+				continue;
+			}
+			unsigned char *ptr = _receiveBuffer.getWritePtr(RECEIVE_SIZE);
+			if (ptr == nullptr) {
+				// Should not happen, messages are much smaller
+				SI_LOG_ERROR("DVBAPI receive buffer overflow, dropping received data");
+				_receiveBuffer.clear();
+				ptr = _receiveBuffer.getWritePtr(RECEIVE_SIZE);
+			}
+			const ssize_t size = _client.recvDatafrom(ptr, _receiveBuffer.getAmountOfBytesToWrite(), MSG_DONTWAIT);
+			if (size > 0) {
+				_receiveBuffer.addAmountOfBytesWritten(size);
+				// Handle the complete messages, a partial one waits for the rest
+				while (_receiveBuffer.getSize() > 0) {
+					const unsigned char *buf = _receiveBuffer.getReadPtr();
+					const std::size_t msgSize = getMessageSize(buf, _receiveBuffer.getSize());
+					if (msgSize == 0) {
+						break;
+					} else if (msgSize == INVALID_MESSAGE_SIZE) {
+						SI_LOG_BIN_DEBUG(buf, _receiveBuffer.getSize(), "Frontend: x, Receive unexpected data");
+						_receiveBuffer.clear();
+						break;
 					}
+					handleMessage(buf);
+					_receiveBuffer.consume(msgSize);
 				}
+			} else if (size == -1 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+				continue;
+			} else {
+				// connection closed, try to reconnect
+				SI_LOG_INFO("Connection lost with @#1", _serverName);
+				_serverName = "Not connected";
+				_client.closeFD();
+				_receiveBuffer.clear();
+				_sendQueue.clear();
+				pfd[0].fd = -1;
+				_connected = false;
 			}
 		}
 	}
 
+	std::size_t Client::getMessageSize(const unsigned char *buf, const std::size_t size) {
+		if (size < 4) {
+			return 0;
+		}
+		const uint32_t cmd = (buf[0] << 24) | (buf[1] << 16) | (buf[2] << 8) | buf[3];
+		std::size_t msgSize = 0;
+		switch (cmd) {
+			case DVBAPI_SERVER_INFO:
+				if (size < 7) {
+					return 0;
+				}
+				msgSize = 7 + buf[6];
+				break;
+			case DVBAPI_DMX_SET_FILTER:
+				msgSize = 65;
+				break;
+			case DVBAPI_DMX_STOP:
+				msgSize = 9;
+				break;
+			case DVBAPI_CA_SET_DESCR:
+				msgSize = 21;
+				break;
+			case DVBAPI_CA_SET_PID:
+				msgSize = 13;
+				break;
+			case DVBAPI_ECM_INFO:
+				// Four strings with a length byte, then the hops
+				msgSize = 19;
+				for (int n = 0; n < 4; ++n) {
+					if (size <= msgSize) {
+						return 0;
+					}
+					msgSize += buf[msgSize] + 1;
+				}
+				msgSize += 1;
+				break;
+			default:
+				return INVALID_MESSAGE_SIZE;
+		}
+		return (size >= msgSize) ? msgSize : 0;
+	}
+
+	void Client::handleMessage(const unsigned char *buf) {
+		// get command
+		const uint32_t cmd = (buf[0] << 24) | (buf[1] << 16) | (buf[2] << 8) | buf[3];
+		switch (cmd) {
+			case DVBAPI_SERVER_INFO: {
+					_serverName.assign(reinterpret_cast<const char *>(&buf[7]), buf[6]);
+					SI_LOG_INFO("Connected to @#1", _serverName);
+					_connected = true;
+					break;
+				}
+			case DVBAPI_DMX_SET_FILTER: {
+					const int adapter =  buf[4] - _adapterOffset;
+					const int demux   =  buf[5];
+					const int filter  =  buf[6];
+					const int pid     = (buf[7] << 8) | buf[8];
+					const unsigned char* filterData = &buf[9];
+					const unsigned char* filterMask = &buf[25];
+
+//					SI_LOG_BIN_DEBUG(buf, 65, "Frontend: @#1, DVBAPI_DMX_SET_FILTER", adapter);
+
+					const input::dvb::SpFrontendDecryptInterface frontend = _streamManager.getFrontendDecryptInterface(adapter);
+					frontend->startOSCamFilterData(pid, demux, filter, filterData, filterMask);
+					break;
+				}
+			case DVBAPI_DMX_STOP: {
+					const int adapter =  buf[4] - _adapterOffset;
+					const int demux   =  buf[5];
+					const int filter  =  buf[6];
+					const int pid     = (buf[7] << 8) | buf[8];
+
+					const input::dvb::SpFrontendDecryptInterface frontend = _streamManager.getFrontendDecryptInterface(adapter);
+					frontend->stopOSCamFilterData(pid, demux, filter);
+					break;
+				}
+			case DVBAPI_CA_SET_DESCR: {
+					const int adapter =  buf[4] - _adapterOffset;
+					const int index   = (buf[5] << 24) | (buf[ 6] << 16) | (buf[ 7] << 8) | buf[ 8];
+					const int parity  = (buf[9] << 24) | (buf[10] << 16) | (buf[11] << 8) | buf[12];
+					unsigned char cw[9];
+					memcpy(cw, &buf[13], 8);
+					cw[8] = 0;
+
+					const input::dvb::SpFrontendDecryptInterface frontend = _streamManager.getFrontendDecryptInterface(adapter);
+					frontend->setKey(cw, parity, index);
+					SI_LOG_DEBUG("Frontend: @#1, Received @#2(@#3) CW: @#4 @#5 @#6 @#7 @#8 @#9 @#10 @#11  index: @#12",
+						frontend->getFeID(), (parity == 0) ? "even" : "odd", HEX2(parity),
+						HEX2(cw[0]), HEX2(cw[1]), HEX2(cw[2]), HEX2(cw[3]),
+						HEX2(cw[4]), HEX2(cw[5]), HEX2(cw[6]), HEX2(cw[7]), index);
+					break;
+				}
+			case DVBAPI_CA_SET_PID: {
+//					const int adapter   =  buf[4] - _adapterOffset;
+//					SI_LOG_BIN_DEBUG(buf, 13, "Frontend: @#1, DVBAPI_CA_SET_PID", adapter);
+					break;
+				}
+			case DVBAPI_ECM_INFO: {
+					const int adapter   =  buf[ 4] - _adapterOffset;
+					const int serviceID = (buf[ 5] <<  8) |  buf[ 6];
+					const int caID      = (buf[ 7] <<  8) |  buf[ 8];
+					const int pid       = (buf[ 9] <<  8) |  buf[10];
+					const int provID    = (buf[11] << 24) | (buf[12] << 16) | (buf[13] << 8) | buf[14];
+					const int emcTime   = (buf[15] << 24) | (buf[16] << 16) | (buf[17] << 8) | buf[18];
+					std::size_t i = 19;
+					std::string cardSystem;
+					cardSystem.assign(reinterpret_cast<const char *>(&buf[i + 1]), buf[i + 0]);
+					i += buf[i + 0] + 1;
+					std::string readerName;
+					readerName.assign(reinterpret_cast<const char *>(&buf[i + 1]), buf[i + 0]);
+					i += buf[i + 0] + 1;
+					std::string sourceName;
+					sourceName.assign(reinterpret_cast<const char *>(&buf[i + 1]), buf[i + 0]);
+					i += buf[i + 0] + 1;
+					std::string protocolName;
+					protocolName.assign(reinterpret_cast<const char *>(&buf[i + 1]), buf[i + 0]);
+					i += buf[i + 0] + 1;
+					const int hops = buf[i];
+
+					const input::dvb::SpFrontendDecryptInterface frontend = _streamManager.getFrontendDecryptInterface(adapter);
+					frontend->setECMInfo(pid, serviceID, caID, provID, emcTime,
+									  cardSystem, readerName, sourceName, protocolName, hops);
+					SI_LOG_DEBUG("Frontend: @#1, Receive ECM Info System: @#2  Reader: @#3  Source: @#4  Protocol: @#5  ECM Time: @#6",
+						frontend->getFeID(), cardSystem, readerName, sourceName, protocolName, emcTime);
+					break;
+				}
+			default:
+				break;
+		}
+	}
+
+	void Client::flushSendQueue() {
+		if (_client.getFD() == -1) {
+			// Not connected, the queue is cleared when connecting
+			return;
+		}
+		if (!_sendQueue.flush(_client)) {
+			SI_LOG_ERROR("Send data to OSCam server failed");
+		}
+	}
+
 	// =======================================================================
 	//  -- base::XMLSupport --------------------------------------------------
 	// =======================================================================
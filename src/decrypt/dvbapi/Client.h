@@ -24,6 +24,8 @@
 #include <FwDecl.h>
 #include <base/ThreadBase.h>
 #include <base/XMLSupport.h>
+#include <decrypt/dvbapi/ReceiveBuffer.h>
+#include <decrypt/dvbapi/SendQueue.h>
 #include <socket/SocketClient.h>
 
 #include <atomic>
@@ -31,11 +33,13 @@
 #include <map>
 
 FW_DECL_NS0(StreamManager);
+FW_DECL_NS2(input, dvb, FrontendDecryptInterface);
 FW_DECL_NS1(mpegts, PacketBuffer);
 FW_DECL_NS1(mpegts, PMT);
 FW_DECL_NS1(mpegts, SDT);
 
 FW_DECL_SP_NS2(decrypt, dvbapi, Client);
+FW_DECL_SP_NS2(decrypt, dvbapi, DecryptWorkerPool);
 
 namespace decrypt::dvbapi {
 
@@ -107,14 +111,49 @@ class Client :
 		// ================================================================
 	public:
 
-		///
-		void decrypt(FeIndex index, FeID id, mpegts::PacketBuffer &buffer);
+		/// Decrypt the scrambled TS packets of the buffers, or collect them into
+		/// the decrypt batch of the frontend
+		/// @param frontend specifies the decrypt interface, resolved by the Stream
+		/// @param buffers specifies the first buffer to decrypt
+		/// @param count specifies the amount of buffers
+		void decrypt(FeIndex index, FeID id, input::dvb::FrontendDecryptInterface &frontend,
+			mpegts::PacketBuffer *buffers, std::size_t count);
+
+		/// Decrypt the partial batch of this frontend, when it waited longer
+		/// then the batch deadline or when it is forced. So buffers with a
+		/// pending decrypt do not have to wait for a full batch
+		/// @param force specifies to decrypt the partial batch anyway
+		void decryptPendingBatch(FeID id, input::dvb::FrontendDecryptInterface &frontend, bool force);
 
 		///
 		bool stopDecrypt(FeIndex index, FeID id);
 
+		/// Decrypt the batches with the worker pool, instead of the reader of
+		/// the frontend. Should be set before streaming starts.
+		/// @param pool specifies the worker pool to use
+		void setDecryptWorkerPool(SpDecryptWorkerPool pool) {
+			_workerPool = pool;
+		}
+
 	private:
 
+		/// Decrypt or collect the scrambled TS packets of one buffer
+		void decrypt(FeIndex index, FeID id, input::dvb::FrontendDecryptInterface &frontend,
+			unsigned int maxBatchSize, mpegts::PacketBuffer &buffer);
+
+		/// Get the size of the message at @p buf
+		/// @param size specifies the amount of received data at @p buf
+		/// @return the size of the message, 0 when it is not complete yet or
+		/// INVALID_MESSAGE_SIZE when it is an unknown message
+		static std::size_t getMessageSize(const unsigned char *buf, std::size_t size);
+
+		/// Handle one complete message from the server
+		void handleMessage(const unsigned char *buf);
+
+		/// Send the queued messages without blocking, the rest is send when
+		/// the socket is writable again
+		void flushSendQueue();
+
 		///
 		bool initClientSocket(
 			SocketClient &client,
@@ -134,12 +173,20 @@ class Client :
 
 		using UCharPtr = std::shared_ptr<unsigned char[]>;
 
+		static constexpr std::size_t INVALID_MESSAGE_SIZE = static_cast<std::size_t>(-1);
+		/// Free space to receive into, the messages from the server are small
+		static constexpr std::size_t RECEIVE_SIZE = 2048;
+		/// Filter data header and the largest section (12 bit length + 3)
+		static constexpr std::size_t MAX_FILTER_DATA_SIZE = 6 + 0xFFF + 3;
+
 		struct PMTEntry {
 			UCharPtr caPtr;
 			int size;
 		};
 
 		SocketClient     _client;
+		ReceiveBuffer    _receiveBuffer;
+		SendQueue        _sendQueue;
 		std::atomic_bool _connected;
 		std::atomic_bool _enabled;
 		std::atomic_bool _rewritePMT;
@@ -148,6 +195,7 @@ class Client :
 		std::string      _serverIPAddr;
 		std::string      _serverName;
 		std::map<int, PMTEntry> _capmtMap;
+		SpDecryptWorkerPool _workerPool;
 
 		StreamManager &_streamManager;
 };
@@ -21,6 +21,7 @@
 
 #include <Utils.h>
 #include <Unused.h>
+#include <decrypt/dvbapi/DecryptWorkerPool.h>
 
 #include <dlfcn.h>
 
@@ -33,10 +34,12 @@ namespace decrypt::dvbapi {
 ClientProperties::ClientProperties() {
 	_batchSizeMax = dvbcsa_bs_batch_size();
 	_batchSize = _batchSizeMax;
-	_batch = new dvbcsa_bs_batch_s[_batchSizeMax + 1];
-	_ts = new dvbcsa_bs_batch_s[_batchSizeMax + 1];
-	_batchCount = 0;
+	for (std::size_t i = 0; i < MAX_JOBS_IN_FLIGHT; ++i) {
+		_jobs.push_back(std::make_unique<DecryptJob>(_batchSizeMax));
+	}
+	_job = 0;
 	_parity = 0;
+	_batchDeadline = DEFAULT_BATCH_DEADLINE_MS;
 	void* handle = dlopen("libdvbcsa.so.1", RTLD_LAZY | RTLD_NODELETE);
 	if (handle != nullptr) {
 		if (dlsym(handle, "dvbcsa_bs_key_set_ecm") == nullptr) {
@@ -51,8 +54,10 @@ ClientProperties::ClientProperties() {
 }
 
 ClientProperties::~ClientProperties() {
-	DELETE_ARRAY(_batch);
-	DELETE_ARRAY(_ts);
+	// Jobs that are still in a worker pool use our buffers
+	for (const std::unique_ptr<DecryptJob> &job : _jobs) {
+		job->waitUntilDone();
+	}
 	_keys.freeKeys();
 }
 
@@ -61,11 +66,22 @@ ClientProperties::~ClientProperties() {
 // =============================================================================
 
 void ClientProperties::doAddToXML(std::string& xml) const {
-	ADD_XML_NUMBER_INPUT(xml, "dvbcsa_bs_batch_size", _batchSize, 0, _batchSizeMax);
+	ADD_XML_NUMBER_INPUT(xml, "dvbcsa_bs_batch_size", _batchSize, 1, _batchSizeMax);
+	ADD_XML_NUMBER_INPUT(xml, "decryptBatchDeadline", _batchDeadline, 0, MAX_BATCH_DEADLINE_MS);
 	ADD_XML_ELEMENT(xml, "icamEnabled", _icamEnabled ? "Yes" : "No");
+	_statistics.addToXML(xml);
 }
 
-void ClientProperties::doFromXML(const std::string& UNUSED(xml)) {
+void ClientProperties::doFromXML(const std::string& xml) {
+	std::string element;
+	if (findXMLElement(xml, "dvbcsa_bs_batch_size.value", element)) {
+		const unsigned int size = std::stoi(element);
+		_batchSize = (size >= 1 && size <= _batchSizeMax) ? size : _batchSizeMax;
+	}
+	if (findXMLElement(xml, "decryptBatchDeadline.value", element)) {
+		const unsigned int deadline = std::stoi(element);
+		_batchDeadline = (deadline <= MAX_BATCH_DEADLINE_MS) ? deadline : DEFAULT_BATCH_DEADLINE_MS;
+	}
 }
 
 // ===========================================================================
@@ -76,35 +92,23 @@ void ClientProperties::stopOSCamFilters(FeID id) {
 	SI_LOG_INFO("Frontend: @#1, Clearing OSCam filters and Keys...", id);
 	// free keys
 	_keys.freeKeys();
-	_batchCount = 0;
-	_parity = 0;
+	// A partial batch is left to the reader, it will be decrypted (to NULL
+	// packets) when its deadline passed
 	_filter.clear();
+	_statistics.restart();
 }
 
-void ClientProperties::decryptBatch() noexcept {
-	const auto key = _keys.get(_parity);
-	if (key != nullptr) {
-		// terminate batch buffer
-		setBatchData(nullptr, 0, _parity, nullptr);
-		// decrypt it
-		dvbcsa_bs_decrypt(key, _batch, 184);
-
-		// clear scramble flags, so we can send it.
-		for (unsigned int i = 0; _ts[i].data != nullptr; ++i) {
-			_ts[i].data[3] &= 0x3F;
-		}
-	} else {
-		for (unsigned int i = 0; _ts[i].data != nullptr; ++i) {
-			// set decrypt failed by setting NULL packet ID..
-			_ts[i].data[1] |= 0x1F;
-			_ts[i].data[2] |= 0xFF;
-
-			// clear scramble flag, so we can send it.
-			_ts[i].data[3] &= 0x3F;
-		}
+void ClientProperties::decryptBatch(DecryptWorkerPool *pool) noexcept {
+	DecryptJob &job = *_jobs[_job];
+	job.prepare(_keys.getReference(_parity), &_statistics);
+	if (pool == nullptr) {
+		job.execute();
+		return;
 	}
-	// decrypted this batch reset counter
-	_batchCount = 0;
+	pool->schedule(&job);
+	// Fill the next job, but wait when it is still in flight
+	_job = (_job + 1) % _jobs.size();
+	_jobs[_job]->waitUntilDone();
 }
 
 void ClientProperties::setECMInfo(
@@ -25,13 +25,21 @@
 #include <mpegts/TableData.h>
 #include <base/TimeCounter.h>
 #include <base/XMLSupport.h>
+#include <decrypt/dvbapi/DecryptJob.h>
+#include <decrypt/dvbapi/DecryptStatistics.h>
 #include <decrypt/dvbapi/Filter.h>
 #include <decrypt/dvbapi/Keys.h>
 
+#include <chrono>
+#include <memory>
+#include <vector>
+
 extern "C" {
 	#include <dvbcsa/dvbcsa.h>
 }
 
+FW_DECL_NS2(decrypt, dvbapi, DecryptWorkerPool);
+
 namespace decrypt::dvbapi {
 
 ///
@@ -73,7 +81,7 @@ class ClientProperties :
 
 		/// Get how big this decrypt batch is
 		unsigned int getBatchCount() const noexcept {
-			return _batchCount;
+			return _jobs[_job]->getCount();
 		}
 
 		/// Get the global parity of this decrypt batch
@@ -85,30 +93,48 @@ class ClientProperties :
 		/// @param ptr specifies the pointer to de data that should be decrypted
 		/// @param len specifies the lenght of data
 		/// @param originalPtr specifies the original TS packet (so we can clear scramble flag when finished)
-		void setBatchData(unsigned char* ptr, unsigned int len, unsigned int parity, unsigned char* originalPtr) noexcept {
-			_batch[_batchCount].data = ptr;
-			_batch[_batchCount].len  = len;
-			_ts[_batchCount].data = originalPtr;
+		/// @param buffer specifies the buffer of the TS packet
+		void setBatchData(unsigned char* ptr, unsigned int len, unsigned int parity,
+				unsigned char* originalPtr, mpegts::PacketBuffer &buffer) noexcept {
+			DecryptJob &job = *_jobs[_job];
+			if (job.getCount() == 0) {
+				_batchStart = std::chrono::steady_clock::now();
+			}
+			job.add(ptr, len, originalPtr, buffer);
 			_parity = parity;
-			++_batchCount;
+		}
+
+		/// Check if the oldest packet in this (partial) decrypt batch waited
+		/// longer then the batch deadline, so it should be decrypted now
+		bool isBatchDeadlineExpired() const noexcept {
+			return getBatchCount() != 0 &&
+				(std::chrono::steady_clock::now() - _batchStart) >= std::chrono::milliseconds(_batchDeadline);
 		}
 
 		/// This function will decrypt the batch upon success it will clear scramble flag
 		/// on failure it will make a NULL TS Packet and clear scramble flag
-		void decryptBatch() noexcept;
+		/// @param pool specifies the worker pool to decrypt it with, nullptr decrypts
+		/// it directly
+		void decryptBatch(DecryptWorkerPool *pool) noexcept;
 
 		/// Set the 'next' key for the requested parity
 		void setKey(const unsigned char* cw, const unsigned int parity, const int index) {
 			_keys.set(cw, parity, index, _icamEnabled);
+			_statistics.cwReceived();
 		}
 
 		void setICAM(const unsigned char ecm, const unsigned int parity) {
 			_keys.setICAM(ecm, parity);
 		}
 
-		/// Get the active key for the requested parity
-		const dvbcsa_bs_key_s* getKey(unsigned int parity) const {
-			return _keys.get(parity);
+		/// Check if there is an active key for the requested parity
+		bool hasKey(unsigned int parity) const noexcept {
+			return _keys.has(parity);
+		}
+
+		/// Get the ECM/CW latency statistics
+		DecryptStatistics &getStatistics() noexcept {
+			return _statistics;
 		}
 
 		/// Start and add the requested filter
@@ -159,15 +185,21 @@ class ClientProperties :
 		// ================================================================
 	private:
 
-		struct dvbcsa_bs_batch_s* _batch;
-		struct dvbcsa_bs_batch_s* _ts;
+		/// The amount of jobs of this frontend that can be decrypted at the same time
+		static constexpr std::size_t MAX_JOBS_IN_FLIGHT = 8;
+		std::vector<std::unique_ptr<DecryptJob>> _jobs;
+		std::size_t _job;
 		unsigned int _batchSizeMax;
 		unsigned int _batchSize;
-		unsigned int _batchCount;
 		unsigned int _parity;
+		static constexpr unsigned int DEFAULT_BATCH_DEADLINE_MS = 20;
+		static constexpr unsigned int MAX_BATCH_DEADLINE_MS = 500;
+		unsigned int _batchDeadline;
+		std::chrono::steady_clock::time_point _batchStart;
 		bool _icamEnabled;
 		Keys _keys;
 		Filter _filter;
+		DecryptStatistics _statistics;
 
 };
 
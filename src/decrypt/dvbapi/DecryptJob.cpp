@@ -0,0 +1,101 @@
+/* DecryptJob.cpp
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <decrypt/dvbapi/DecryptJob.h>
+
+#include <decrypt/dvbapi/DecryptStatistics.h>
+#include <mpegts/PacketBuffer.h>
+
+namespace decrypt::dvbapi {
+
+// =============================================================================
+//  -- Constructors and destructor ---------------------------------------------
+// =============================================================================
+
+DecryptJob::DecryptJob(const unsigned int batchSizeMax) :
+	_batch(new dvbcsa_bs_batch_s[batchSizeMax + 1]),
+	_ts(new unsigned char*[batchSizeMax]),
+	_buffer(new mpegts::PacketBuffer*[batchSizeMax]),
+	_count(0),
+	_bufferCount(0),
+	_statistics(nullptr),
+	_busy(false) {}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void DecryptJob::add(unsigned char* ptr, const unsigned int len,
+		unsigned char* originalPtr, mpegts::PacketBuffer &buffer) noexcept {
+	_batch[_count].data = ptr;
+	_batch[_count].len  = len;
+	_ts[_count] = originalPtr;
+	++_count;
+	// The packets of one buffer are added after each other
+	if (_bufferCount == 0 || _buffer[_bufferCount - 1] != &buffer) {
+		buffer.addDecryptReference();
+		_buffer[_bufferCount] = &buffer;
+		++_bufferCount;
+	}
+}
+
+void DecryptJob::execute() noexcept {
+	if (_key) {
+		// terminate batch buffer
+		_batch[_count].data = nullptr;
+		_batch[_count].len  = 0;
+		// decrypt it
+		dvbcsa_bs_decrypt(_key.get(), _batch.get(), 184);
+
+		// clear scramble flags, so we can send it.
+		for (unsigned int i = 0; i < _count; ++i) {
+			_ts[i][3] &= 0x3F;
+		}
+		if (_statistics != nullptr && _count != 0) {
+			_statistics->batchDescrambled();
+		}
+	} else {
+		for (unsigned int i = 0; i < _count; ++i) {
+			// set decrypt failed by setting NULL packet ID..
+			_ts[i][1] |= 0x1F;
+			_ts[i][2] |= 0xFF;
+
+			// clear scramble flag, so we can send it.
+			_ts[i][3] &= 0x3F;
+		}
+	}
+	// decrypted this batch, so the buffers can be send
+	for (unsigned int i = 0; i < _bufferCount; ++i) {
+		_buffer[i]->releaseDecryptReference();
+	}
+	_key.reset();
+	_count = 0;
+	_bufferCount = 0;
+	// Notify with the lock held, the waiter may delete this job when it is done
+	std::lock_guard<std::mutex> lock(_mutex);
+	_busy.store(false, std::memory_order_release);
+	_cond.notify_all();
+}
+
+void DecryptJob::waitUntilDone() {
+	std::unique_lock<std::mutex> lock(_mutex);
+	_cond.wait(lock, [this] { return !isBusy(); });
+}
+
+}
@@ -0,0 +1,117 @@
+/* DecryptJob.h
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef DECRYPT_DVBAPI_DECRYPT_JOB_H_INCLUDE
+#define DECRYPT_DVBAPI_DECRYPT_JOB_H_INCLUDE DECRYPT_DVBAPI_DECRYPT_JOB_H_INCLUDE
+
+#include <FwDecl.h>
+#include <decrypt/dvbapi/Keys.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+extern "C" {
+	#include <dvbcsa/dvbcsa.h>
+}
+
+FW_DECL_NS1(mpegts, PacketBuffer);
+FW_DECL_NS2(decrypt, dvbapi, DecryptStatistics);
+
+namespace decrypt::dvbapi {
+
+/// The class @c DecryptJob is one batch of scrambled TS packets, with the
+/// same parity, that is decrypted in one go. It can be decrypted by the
+/// reader of the frontend or by a @c DecryptWorkerPool
+class DecryptJob {
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		/// @param batchSizeMax specifies the maximum amount of TS packets in this job
+		explicit DecryptJob(unsigned int batchSizeMax);
+
+		virtual ~DecryptJob() = default;
+
+		DecryptJob(const DecryptJob&) = delete;
+
+		DecryptJob& operator=(const DecryptJob&) = delete;
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Get the amount of TS packets in this job
+		unsigned int getCount() const noexcept {
+			return _count;
+		}
+
+		/// Add one TS packet to this job
+		/// @param ptr specifies the pointer to de data that should be decrypted
+		/// @param len specifies the lenght of data
+		/// @param originalPtr specifies the original TS packet (so we can clear scramble flag when finished)
+		/// @param buffer specifies the buffer of the TS packet, it is not send before this job is done
+		void add(unsigned char* ptr, unsigned int len, unsigned char* originalPtr,
+				mpegts::PacketBuffer &buffer) noexcept;
+
+		/// Mark this job as busy, it will be decrypted with the requested key
+		/// @param key specifies the key to use, nullptr will make NULL TS packets
+		/// @param statistics specifies the statistics to tell when it is descrambled
+		void prepare(Keys::SpKey key, DecryptStatistics *statistics) noexcept {
+			_key = std::move(key);
+			_statistics = statistics;
+			_busy.store(true, std::memory_order_relaxed);
+		}
+
+		/// Check if this job is scheduled and not done yet, so it can not be filled
+		bool isBusy() const noexcept {
+			return _busy.load(std::memory_order_acquire);
+		}
+
+		/// Wait until this job is done, so it can be filled again
+		void waitUntilDone();
+
+		/// This function will decrypt this job upon success it will clear scramble flag
+		/// on failure it will make a NULL TS Packet and clear scramble flag. Then the
+		/// buffers are released and this job can be filled again.
+		void execute() noexcept;
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		std::unique_ptr<dvbcsa_bs_batch_s[]> _batch;
+		std::unique_ptr<unsigned char*[]> _ts;
+		std::unique_ptr<mpegts::PacketBuffer*[]> _buffer;
+		unsigned int _count;
+		unsigned int _bufferCount;
+		Keys::SpKey _key;
+		DecryptStatistics *_statistics;
+		std::atomic_bool _busy;
+		std::mutex _mutex;
+		std::condition_variable _cond;
+};
+
+}
+
+#endif // DECRYPT_DVBAPI_DECRYPT_JOB_H_INCLUDE
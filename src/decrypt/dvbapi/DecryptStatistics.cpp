@@ -0,0 +1,105 @@
+/* DecryptStatistics.cpp
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <decrypt/dvbapi/DecryptStatistics.h>
+
+#include <StringConverter.h>
+#include <base/XMLSupport.h>
+
+#include <chrono>
+
+namespace decrypt::dvbapi {
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void DecryptStatistics::addToXML(std::string &xml) const {
+	ADD_XML_ELEMENT(xml, "ecmCount", _ecmCount.load(std::memory_order_relaxed));
+	ADD_XML_ELEMENT(xml, "cwCount", _cwCount.load(std::memory_order_relaxed));
+	ADD_XML_ELEMENT(xml, "noKeyDroppedPackets", _droppedPackets.load(std::memory_order_relaxed));
+	_ecmToSent.addToXML(xml, "ecmToSentLatency");
+	_sentToCW.addToXML(xml, "sentToCWLatency");
+	_ecmToCW.addToXML(xml, "ecmToCWLatency");
+	_ecmToFirstPacket.addToXML(xml, "ecmToFirstPacketLatency");
+}
+
+void DecryptStatistics::restart() noexcept {
+	_ecmSeenTime.store(0, std::memory_order_relaxed);
+	_ecmSentTime.store(0, std::memory_order_relaxed);
+	_firstECMTime.store(0, std::memory_order_relaxed);
+	_waitingForFirstPacket.store(true, std::memory_order_relaxed);
+}
+
+void DecryptStatistics::ecmSeen() noexcept {
+	_ecmCount.fetch_add(1, std::memory_order_relaxed);
+	const std::int64_t t = now();
+	// Keep the time of the oldest ECM that is not answered yet
+	std::int64_t expected = 0;
+	_ecmSeenTime.compare_exchange_strong(expected, t, std::memory_order_relaxed);
+	if (_waitingForFirstPacket.load(std::memory_order_relaxed)) {
+		expected = 0;
+		_firstECMTime.compare_exchange_strong(expected, t, std::memory_order_relaxed);
+	}
+}
+
+void DecryptStatistics::ecmSent() noexcept {
+	const std::int64_t seen = _ecmSeenTime.load(std::memory_order_relaxed);
+	if (seen == 0) {
+		return;
+	}
+	const std::int64_t t = now();
+	std::int64_t expected = 0;
+	if (_ecmSentTime.compare_exchange_strong(expected, t, std::memory_order_relaxed)) {
+		_ecmToSent.add(t - seen);
+	}
+}
+
+void DecryptStatistics::cwReceived() noexcept {
+	_cwCount.fetch_add(1, std::memory_order_relaxed);
+	const std::int64_t t = now();
+	const std::int64_t seen = _ecmSeenTime.exchange(0, std::memory_order_relaxed);
+	const std::int64_t sent = _ecmSentTime.exchange(0, std::memory_order_relaxed);
+	if (seen != 0 && t >= seen) {
+		_ecmToCW.add(t - seen);
+	}
+	if (sent != 0 && t >= sent) {
+		_sentToCW.add(t - sent);
+	}
+}
+
+void DecryptStatistics::firstPacketDescrambled() noexcept {
+	// Only the first packet after the first ECM of this channel counts
+	const std::int64_t first = _firstECMTime.load(std::memory_order_relaxed);
+	if (first == 0) {
+		return;
+	}
+	if (_waitingForFirstPacket.exchange(false, std::memory_order_relaxed)) {
+		const std::int64_t t = now();
+		_ecmToFirstPacket.add((t >= first) ? t - first : 0);
+	}
+}
+
+std::int64_t DecryptStatistics::now() noexcept {
+	// Add one, so a valid time is never 0
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count() + 1;
+}
+
+}
@@ -0,0 +1,108 @@
+/* DecryptStatistics.h
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef DECRYPT_DVBAPI_DECRYPT_STATISTICS_H_INCLUDE
+#define DECRYPT_DVBAPI_DECRYPT_STATISTICS_H_INCLUDE DECRYPT_DVBAPI_DECRYPT_STATISTICS_H_INCLUDE
+
+#include <base/LatencyHistogram.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace decrypt::dvbapi {
+
+/// The class @c DecryptStatistics follows the latency from ECM to CW and to
+/// the first descrambled packet of one frontend. The events come from the
+/// stream thread, the decrypt workers and the DVBAPI client thread, so it is
+/// all lock-free.
+class DecryptStatistics {
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		DecryptStatistics() = default;
+
+		virtual ~DecryptStatistics() = default;
+
+		DecryptStatistics(const DecryptStatistics&) = delete;
+
+		DecryptStatistics& operator=(const DecryptStatistics&) = delete;
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Add the statistics to @p xml
+		void addToXML(std::string &xml) const;
+
+		/// A new channel is being descrambled, so wait for its first packet again
+		void restart() noexcept;
+
+		/// An ECM section was found by an OSCam filter
+		void ecmSeen() noexcept;
+
+		/// The found ECM section is written to OSCam
+		void ecmSent() noexcept;
+
+		/// A CW was received from OSCam
+		void cwReceived() noexcept;
+
+		/// A batch of scrambled packets is descrambled with a key
+		void batchDescrambled() noexcept {
+			if (_waitingForFirstPacket.load(std::memory_order_relaxed)) {
+				firstPacketDescrambled();
+			}
+		}
+
+		/// A scrambled packet is made a NULL packet, because there was no key
+		void packetDropped() noexcept {
+			_droppedPackets.fetch_add(1, std::memory_order_relaxed);
+		}
+
+	private:
+
+		void firstPacketDescrambled() noexcept;
+
+		/// Get the current time in ms, 0 is used for 'not set'
+		static std::int64_t now() noexcept;
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		std::atomic<std::int64_t> _ecmSeenTime{0};
+		std::atomic<std::int64_t> _ecmSentTime{0};
+		std::atomic<std::int64_t> _firstECMTime{0};
+		std::atomic_bool _waitingForFirstPacket{true};
+		std::atomic<std::uint64_t> _ecmCount{0};
+		std::atomic<std::uint64_t> _cwCount{0};
+		std::atomic<std::uint64_t> _droppedPackets{0};
+		base::LatencyHistogram _ecmToSent;
+		base::LatencyHistogram _sentToCW;
+		base::LatencyHistogram _ecmToCW;
+		base::LatencyHistogram _ecmToFirstPacket;
+};
+
+}
+
+#endif // DECRYPT_DVBAPI_DECRYPT_STATISTICS_H_INCLUDE
@@ -0,0 +1,79 @@
+/* DecryptWorkerPool.cpp
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <decrypt/dvbapi/DecryptWorkerPool.h>
+
+#include <Log.h>
+#include <StringConverter.h>
+#include <decrypt/dvbapi/DecryptJob.h>
+
+namespace decrypt::dvbapi {
+
+// =============================================================================
+//  -- Constructors and destructor ---------------------------------------------
+// =============================================================================
+
+DecryptWorkerPool::DecryptWorkerPool(const std::size_t numberOfThreads) {
+	for (std::size_t i = 0; i < numberOfThreads; ++i) {
+		_threads.push_back(std::make_unique<base::Thread>(
+			StringConverter::stringFormat("Decrypt@#1", i),
+			std::bind(&DecryptWorkerPool::threadExecuteWorker, this)));
+		_threads.back()->startThread();
+	}
+	SI_LOG_INFO("DecryptWorkerPool: Started with @#1 worker threads", _threads.size());
+}
+
+DecryptWorkerPool::~DecryptWorkerPool() {
+	_cond.notify_all();
+	_threads.clear();
+	// Finish the jobs that are left, their frontends are waiting for them
+	for (DecryptJob *job : _pending) {
+		job->execute();
+	}
+	_pending.clear();
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void DecryptWorkerPool::schedule(DecryptJob *job) {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_pending.push_back(job);
+	}
+	_cond.notify_one();
+}
+
+bool DecryptWorkerPool::threadExecuteWorker() {
+	DecryptJob *job = nullptr;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		if (_pending.empty()) {
+			_cond.wait_for(lock, std::chrono::milliseconds(100));
+			return true;
+		}
+		job = _pending.front();
+		_pending.pop_front();
+	}
+	job->execute();
+	return true;
+}
+
+}
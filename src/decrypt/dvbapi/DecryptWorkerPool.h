@@ -0,0 +1,87 @@
+/* DecryptWorkerPool.h
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef DECRYPT_DVBAPI_DECRYPT_WORKER_POOL_H_INCLUDE
+#define DECRYPT_DVBAPI_DECRYPT_WORKER_POOL_H_INCLUDE DECRYPT_DVBAPI_DECRYPT_WORKER_POOL_H_INCLUDE
+
+#include <FwDecl.h>
+#include <base/Thread.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+FW_DECL_NS2(decrypt, dvbapi, DecryptJob);
+
+FW_DECL_SP_NS2(decrypt, dvbapi, DecryptWorkerPool);
+
+namespace decrypt::dvbapi {
+
+/// The class @c DecryptWorkerPool decrypts the jobs of all frontends with a
+/// pool of worker threads, so the decrypting of one busy frontend is spread
+/// over multiple cores instead of its reader thread. The jobs may finish in
+/// any order, the buffers are still send in order because a buffer is not
+/// send before all its jobs are done.
+class DecryptWorkerPool {
+		// =========================================================================
+		// -- Constructors and destructor ------------------------------------------
+		// =========================================================================
+	public:
+
+		/// @param numberOfThreads specifies the amount of worker threads to use
+		explicit DecryptWorkerPool(std::size_t numberOfThreads);
+
+		virtual ~DecryptWorkerPool();
+
+		DecryptWorkerPool(const DecryptWorkerPool&) = delete;
+
+		DecryptWorkerPool& operator=(const DecryptWorkerPool&) = delete;
+
+		// =========================================================================
+		//  -- Other member functions ----------------------------------------------
+		// =========================================================================
+	public:
+
+		/// Schedule the job for decrypting, it should be prepared already
+		/// @param job specifies the job to decrypt, it should stay valid until it is done
+		void schedule(DecryptJob *job);
+
+	private:
+
+		/// Thread execute function @see base::Thread should @return true to
+		/// keep thread running and @return false will stop and then terminate this thread
+		bool threadExecuteWorker();
+
+		// =========================================================================
+		// -- Data members ---------------------------------------------------------
+		// =========================================================================
+	private:
+
+		std::mutex _mutex;
+		std::condition_variable _cond;
+		std::deque<DecryptJob *> _pending;
+		std::vector<std::unique_ptr<base::Thread>> _threads;
+};
+
+}
+
+#endif // DECRYPT_DVBAPI_DECRYPT_WORKER_POOL_H_INCLUDE
@@ -24,11 +24,18 @@
 #include <base/Mutex.h>
 #include <decrypt/dvbapi/FilterData.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace decrypt::dvbapi {
 
-	/// The class @c Filter are all available filters for OSCam
+	/// The class @c Filter are all available filters for OSCam. Per PID it keeps
+	/// the amount of active filters and an index to them, so the packets on PIDs
+	/// without a filter are rejected without a lock or a search.
 	class Filter {
 			// =======================================================================
 			//  -- Constructors and destructor ---------------------------------------
@@ -48,31 +55,41 @@ namespace decrypt::dvbapi {
 			void start(const FeID id, int pid, unsigned int demux, unsigned int filter,
 					const unsigned char* filterData, const unsigned char* filterMask) {
 				base::MutexLock lock(_mutex);
-				if (demux < DEMUX_SIZE && filter < FILTER_SIZE) {
+				if (demux < DEMUX_SIZE && filter < FILTER_SIZE && pid >= 0 && pid < PID_SIZE) {
+					removeFromIndex(demux, filter);
 					_filterData[demux][filter].set(id, pid, filterData, filterMask);
+					addToIndex(demux, filter);
 				}
 			}
 
 			/// Find the correct filter for the 'collected' data or ts packet
 			bool find(const FeID id, const int pid, const unsigned char* data, const int tableID,
 					unsigned int& filter, unsigned int& demux, mpegts::TSData& filterData) {
+				// Most PIDs have no filter, so check that first without locking
+				if (pid < 0 || pid >= PID_SIZE || _pidFilterCount[pid].load(std::memory_order_acquire) == 0) {
+					return false;
+				}
 				base::MutexLock lock(_mutex);
-				for (demux = 0; demux < DEMUX_SIZE; ++demux) {
-					for (filter = 0; filter < FILTER_SIZE; ++filter) {
-						// Find filter with correct id and PID
-						if (!_filterData[demux][filter].activeWith(id, pid)) {
-							continue;
-						}
-						// Does filter matches with 'data' or already collecting
-						if (_filterData[demux][filter].matchOrCollecting(data)) {
-							// Collect table data
-							_filterData[demux][filter].collectRawTableData(id, tableID, data, false);
-							if (_filterData[demux][filter].isTableCollected()) {
-								// Finished there is only 1 section
-								filterData = _filterData[demux][filter].getTableData(0);
-								_filterData[demux][filter].resetTableData();
-								return true;
-							}
+				const auto it = _pidIndex.find(pid);
+				if (it == _pidIndex.end()) {
+					return false;
+				}
+				for (const unsigned int slot : it->second) {
+					demux = slot / FILTER_SIZE;
+					filter = slot % FILTER_SIZE;
+					// Find filter with correct id and PID
+					if (!_filterData[demux][filter].activeWith(id, pid)) {
+						continue;
+					}
+					// Does filter matches with 'data' or already collecting
+					if (_filterData[demux][filter].matchOrCollecting(data)) {
+						// Collect table data
+						_filterData[demux][filter].collectRawTableData(id, tableID, data, false);
+						if (_filterData[demux][filter].isTableCollected()) {
+							// Finished there is only 1 section
+							filterData = _filterData[demux][filter].getTableData(0);
+							_filterData[demux][filter].resetTableData();
+							return true;
 						}
 					}
 				}
@@ -83,6 +100,7 @@ namespace decrypt::dvbapi {
 			void stop(unsigned int demux, unsigned int filter) {
 				base::MutexLock lock(_mutex);
 				if (demux < DEMUX_SIZE && filter < FILTER_SIZE) {
+					removeFromIndex(demux, filter);
 					_filterData[demux][filter].clear();
 				}
 			}
@@ -91,6 +109,7 @@ namespace decrypt::dvbapi {
 				base::MutexLock lock(_mutex);
 				for (unsigned int demux = 0; demux < DEMUX_SIZE; ++demux) {
 					for (unsigned int filter = 0; filter < FILTER_SIZE; ++filter) {
+						removeFromIndex(demux, filter);
 						_filterData[demux][filter].clear();
 					}
 				}
@@ -119,6 +138,38 @@ namespace decrypt::dvbapi {
 				return pids;
 			}
 
+		private:
+
+			/// Add the active filter to the PID index, call it with _mutex locked
+			void addToIndex(unsigned int demux, unsigned int filter) {
+				const int pid = _filterData[demux][filter].getAssociatedPID();
+				std::vector<unsigned int> &slots = _pidIndex[pid];
+				// Keep the demux and filter order, like searching all filters
+				const unsigned int slot = (demux * FILTER_SIZE) + filter;
+				slots.insert(std::lower_bound(slots.begin(), slots.end(), slot), slot);
+				_pidFilterCount[pid].fetch_add(1, std::memory_order_release);
+			}
+
+			/// Remove the filter from the PID index, when it is active. Call it
+			/// with _mutex locked
+			void removeFromIndex(unsigned int demux, unsigned int filter) {
+				if (!_filterData[demux][filter].active()) {
+					return;
+				}
+				const int pid = _filterData[demux][filter].getAssociatedPID();
+				const auto it = _pidIndex.find(pid);
+				if (it == _pidIndex.end()) {
+					return;
+				}
+				const unsigned int slot = (demux * FILTER_SIZE) + filter;
+				std::vector<unsigned int> &slots = it->second;
+				slots.erase(std::remove(slots.begin(), slots.end(), slot), slots.end());
+				if (slots.empty()) {
+					_pidIndex.erase(it);
+				}
+				_pidFilterCount[pid].fetch_sub(1, std::memory_order_release);
+			}
+
 			// =======================================================================
 			//  -- Data members ------------------------------------------------------
 			// =======================================================================
@@ -126,9 +177,12 @@ namespace decrypt::dvbapi {
 
 			static constexpr unsigned int DEMUX_SIZE  = 25;
 			static constexpr unsigned int FILTER_SIZE = 15;
+			static constexpr int PID_SIZE = 8192;
 
 			base::Mutex _mutex;
 			FilterData _filterData[DEMUX_SIZE][FILTER_SIZE];
+			std::unordered_map<int, std::vector<unsigned int>> _pidIndex;
+			std::atomic<uint16_t> _pidFilterCount[PID_SIZE] = {};
 	};
 
 }
@@ -33,55 +33,22 @@ namespace decrypt::dvbapi {
 // =============================================================================
 
 void Keys::set(const unsigned char* cw, unsigned int parity, int UNUSED(index), const bool icamEnabled) {
-	dvbcsa_bs_key_s* k = dvbcsa_bs_key_alloc();
-	const unsigned char icamECM = (_icam[parity].size() > 0) ? _icam[parity].back() : 0;
+	const SpKey k(dvbcsa_bs_key_alloc(), dvbcsa_bs_key_free);
 	if (icamEnabled) {
-		dvbcsa_bs_key_set_ecm(icamECM, cw, k);
+		dvbcsa_bs_key_set_ecm(_icam[parity].load(std::memory_order_relaxed), cw, k.get());
 	} else {
-		dvbcsa_bs_key_set(cw, k);
-	}
-	_key[parity].push(std::make_tuple(base::TimeCounter::getTicks(), k));
-	while (_key[parity].size() > 1) {
-		remove(parity);
-	}
-}
-
-void Keys::setICAM(const unsigned char ecm, unsigned int parity) {
-	_icam[parity].push(ecm);
-	while (_icam[parity].size() > 1) {
-		_icam[parity].pop();
-	}
-}
-
-const dvbcsa_bs_key_s* Keys::get(unsigned int parity) const {
-	if (!_key[parity].empty()) {
-		const KeyTuple tup = _key[parity].back();
-//		const long duration = base::TimeCounter::getTicks() - pair.first;
-		return std::get<1>(tup);
-	} else {
-		return nullptr;
+		dvbcsa_bs_key_set(cw, k.get());
 	}
+	// Swap in the new key, a job that still uses the old one keeps it alive
+	std::atomic_store(&_key[parity], k);
+	_active[parity].store(true, std::memory_order_release);
 }
 
 void Keys::freeKeys() {
-	while (!_key[0].empty()) {
-		remove(0);
-	}
-	while (!_key[1].empty()) {
-		remove(1);
-	}
-	while (_icam[0].size() > 1) {
-		_icam[0].pop();
+	for (unsigned int parity = 0; parity < 2; ++parity) {
+		_active[parity].store(false, std::memory_order_release);
+		std::atomic_store(&_key[parity], SpKey());
 	}
-	while (_icam[1].size() > 1) {
-		_icam[1].pop();
-	}
-}
-
-void Keys::remove(unsigned int parity) {
-	const KeyTuple tup = _key[parity].front();
-	dvbcsa_bs_key_free(std::get<1>(tup));
-	_key[parity].pop();
 }
 
 }
@@ -21,23 +21,23 @@
 #define DECRYPT_DVBAPI_KEYS_H_INCLUDE DECRYPT_DVBAPI_KEYS_H_INCLUDE
 
 #include <FwDecl.h>
-#include <base/TimeCounter.h>
-#include <Log.h>
 
-#include <utility>
-#include <queue>
-#include <tuple>
+#include <atomic>
+#include <memory>
 
 FW_DECL_NS0(dvbcsa_bs_key_s);
 
 namespace decrypt::dvbapi {
 
-///
+/// The class @c Keys has the active key for each parity. The keys are set by
+/// the DVBAPI client thread and used by the reader or a decrypt worker at the
+/// same time, so a key is swapped atomically and freed with its last reference.
+/// This way a control word update never waits for or races with decrypting.
 class Keys {
 	public:
-		using KeyTuple = std::tuple<long, dvbcsa_bs_key_s *>;
-		using KeyQueue = std::queue<KeyTuple>;
-		using ICAMQueue = std::queue<unsigned char>;
+		/// The key is freed when the last reference is gone, so a decrypt job
+		/// can keep using it after it is replaced
+		using SpKey = std::shared_ptr<dvbcsa_bs_key_s>;
 
 		// =========================================================================
 		//  -- Constructors and destructor -----------------------------------------
@@ -48,30 +48,47 @@ class Keys {
 
 		virtual ~Keys() = default;
 
+		Keys(const Keys&) = delete;
+
+		Keys& operator=(const Keys&) = delete;
+
 		// =========================================================================
 		//  -- Other member functions ----------------------------------------------
 		// =========================================================================
 	public:
 
+		/// Set the 'next' key for the requested parity, the previous key is freed
+		/// when it is not used anymore
 		void set(const unsigned char* cw, unsigned int parity, int index, bool icamEnabled);
 
-		void setICAM(const unsigned char ecm, unsigned int parity);
-
-		const dvbcsa_bs_key_s *get(unsigned int parity) const;
+		///
+		void setICAM(const unsigned char ecm, unsigned int parity) {
+			_icam[parity].store(ecm, std::memory_order_relaxed);
+		}
 
-		void freeKeys();
+		/// Check if there is an active key for the requested parity
+		bool has(unsigned int parity) const noexcept {
+			return _active[parity].load(std::memory_order_acquire);
+		}
 
-	private:
+		/// Get a reference to the active key for the requested parity, it
+		/// stays valid until the reference is released
+		SpKey getReference(unsigned int parity) const {
+			return std::atomic_load(&_key[parity]);
+		}
 
-		void remove(unsigned int parity);
+		/// Remove the active keys, they are freed when they are not used anymore
+		void freeKeys();
 
 		// =====================================================================
 		//  -- Data members ----------------------------------------------------
 		// =====================================================================
 	private:
 
-		KeyQueue _key[2];
-		ICAMQueue _icam[2];
+		/// Only accessed with std::atomic_load and std::atomic_store
+		SpKey _key[2];
+		std::atomic_bool _active[2] = {false, false};
+		std::atomic<unsigned char> _icam[2] = {0, 0};
 };
 
 }
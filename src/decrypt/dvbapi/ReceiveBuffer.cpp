@@ -0,0 +1,51 @@
+/* ReceiveBuffer.cpp
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <decrypt/dvbapi/ReceiveBuffer.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace decrypt::dvbapi {
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+unsigned char *ReceiveBuffer::getWritePtr(const std::size_t minFree) {
+	if (getAmountOfBytesToWrite() < minFree) {
+		// First move the data that is not handled yet to the begin
+		const std::size_t size = getSize();
+		if (_readIndex != 0) {
+			std::memmove(_buffer.data(), _buffer.data() + _readIndex, size);
+			_readIndex = 0;
+			_writeIndex = size;
+		}
+		if (getAmountOfBytesToWrite() < minFree) {
+			const std::size_t newSize = std::max(_buffer.size() * 2, size + minFree);
+			if (newSize > MAX_SIZE) {
+				return nullptr;
+			}
+			_buffer.resize(newSize);
+		}
+	}
+	return _buffer.data() + _writeIndex;
+}
+
+}
@@ -0,0 +1,106 @@
+/* ReceiveBuffer.h
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef DECRYPT_DVBAPI_RECEIVE_BUFFER_H_INCLUDE
+#define DECRYPT_DVBAPI_RECEIVE_BUFFER_H_INCLUDE DECRYPT_DVBAPI_RECEIVE_BUFFER_H_INCLUDE
+
+#include <cstddef>
+#include <vector>
+
+namespace decrypt::dvbapi {
+
+/// The class @c ReceiveBuffer collects the received DVBAPI data, so a message
+/// that is split over several receives can be handled when it is complete.
+/// It grows when a message does not fit.
+class ReceiveBuffer {
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		ReceiveBuffer() :
+			_buffer(INITIAL_SIZE),
+			_readIndex(0),
+			_writeIndex(0) {}
+
+		virtual ~ReceiveBuffer() = default;
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Get the write pointer with at least @p minFree bytes free, the
+		/// buffer is compacted or grown when needed
+		/// @return nullptr when the buffer would grow beyond MAX_SIZE
+		unsigned char *getWritePtr(std::size_t minFree);
+
+		/// Get the amount of bytes that can be written to the write pointer
+		std::size_t getAmountOfBytesToWrite() const noexcept {
+			return _buffer.size() - _writeIndex;
+		}
+
+		/// Add the amount of bytes written to the write pointer
+		void addAmountOfBytesWritten(std::size_t size) noexcept {
+			_writeIndex += size;
+		}
+
+		/// Get the begin of the received data that is not handled yet
+		const unsigned char *getReadPtr() const noexcept {
+			return _buffer.data() + _readIndex;
+		}
+
+		/// Get the amount of received data that is not handled yet
+		std::size_t getSize() const noexcept {
+			return _writeIndex - _readIndex;
+		}
+
+		/// Mark the first @p size bytes of the received data as handled
+		void consume(std::size_t size) noexcept {
+			_readIndex += size;
+			if (_readIndex == _writeIndex) {
+				_readIndex = 0;
+				_writeIndex = 0;
+			}
+		}
+
+		/// Clear all received data, for instance when the connection is lost
+		void clear() noexcept {
+			_readIndex = 0;
+			_writeIndex = 0;
+		}
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	public:
+
+		static constexpr std::size_t INITIAL_SIZE = 4096;
+		static constexpr std::size_t MAX_SIZE = 65536;
+
+	private:
+
+		std::vector<unsigned char> _buffer;
+		std::size_t _readIndex;
+		std::size_t _writeIndex;
+};
+
+}
+
+#endif // DECRYPT_DVBAPI_RECEIVE_BUFFER_H_INCLUDE
@@ -0,0 +1,117 @@
+/* SendQueue.cpp
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <decrypt/dvbapi/SendQueue.h>
+
+#include <Log.h>
+#include <decrypt/dvbapi/DecryptStatistics.h>
+#include <socket/SocketClient.h>
+
+#include <sys/uio.h>
+
+namespace decrypt::dvbapi {
+
+// =============================================================================
+//  -- Constructors and destructor ---------------------------------------------
+// =============================================================================
+
+SendQueue::SendQueue() :
+	_offset(0) {
+	_free.resize(PREALLOCATED_MESSAGES);
+	for (Message &message : _free) {
+		message.reserve(PREALLOCATED_MESSAGE_SIZE);
+	}
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+bool SendQueue::push(const unsigned char *data, const std::size_t size,
+		DecryptStatistics *statistics) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_queue.size() >= MAX_MESSAGES) {
+		SI_LOG_ERROR("DVBAPI send queue full, dropping message with size @#1", size);
+		return false;
+	}
+	if (_free.empty()) {
+		_queue.push_back({Message(), statistics});
+	} else {
+		_queue.push_back({std::move(_free.back()), statistics});
+		_free.pop_back();
+	}
+	_queue.back().data.assign(data, data + size);
+	return true;
+}
+
+bool SendQueue::flush(SocketClient &client) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	while (!_queue.empty()) {
+		iovec iov[MAX_IOV];
+		std::size_t iovcnt = 0;
+		for (std::size_t i = 0; i < _queue.size() && iovcnt < MAX_IOV; ++i) {
+			const std::size_t offset = (i == 0) ? _offset : 0;
+			iov[iovcnt].iov_base = _queue[i].data.data() + offset;
+			iov[iovcnt].iov_len  = _queue[i].data.size() - offset;
+			++iovcnt;
+		}
+		ssize_t written = client.writeDataNonBlocking(iov, iovcnt);
+		if (written == -1) {
+			return false;
+		} else if (written == 0) {
+			// Socket would block, try again when it is writable
+			return true;
+		}
+		// Release the messages that are send completely
+		while (written > 0) {
+			QueuedMessage &message = _queue.front();
+			const std::size_t left = message.data.size() - _offset;
+			if (static_cast<std::size_t>(written) < left) {
+				_offset += written;
+				break;
+			}
+			written -= left;
+			_offset = 0;
+			if (message.statistics != nullptr) {
+				message.statistics->ecmSent();
+			}
+			message.data.clear();
+			_free.push_back(std::move(message.data));
+			_queue.pop_front();
+		}
+	}
+	return true;
+}
+
+bool SendQueue::hasPending() const {
+	std::lock_guard<std::mutex> lock(_mutex);
+	return !_queue.empty();
+}
+
+void SendQueue::clear() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	while (!_queue.empty()) {
+		_queue.front().data.clear();
+		_free.push_back(std::move(_queue.front().data));
+		_queue.pop_front();
+	}
+	_offset = 0;
+}
+
+}
@@ -0,0 +1,104 @@
+/* SendQueue.h
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef DECRYPT_DVBAPI_SEND_QUEUE_H_INCLUDE
+#define DECRYPT_DVBAPI_SEND_QUEUE_H_INCLUDE DECRYPT_DVBAPI_SEND_QUEUE_H_INCLUDE
+
+#include <FwDecl.h>
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+FW_DECL_NS0(SocketClient);
+FW_DECL_NS2(decrypt, dvbapi, DecryptStatistics);
+
+namespace decrypt::dvbapi {
+
+/// The class @c SendQueue queues the DVBAPI messages for OSCam, so the messages
+/// of a burst (filter data and CA PMT lists at zap time) are send with one
+/// call. The message buffers are reused, so queueing does not allocate once
+/// they are grown to size. It can be used from several threads.
+class SendQueue {
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		SendQueue();
+
+		virtual ~SendQueue() = default;
+
+		SendQueue(const SendQueue&) = delete;
+
+		SendQueue& operator=(const SendQueue&) = delete;
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Queue a copy of the message
+		/// @param statistics specifies the statistics that should be told when
+		/// this (ECM) message is send completely, or nullptr
+		/// @return false when the queue is full and the message is dropped
+		bool push(const unsigned char *data, std::size_t size,
+			DecryptStatistics *statistics = nullptr);
+
+		/// Send as much of the queued messages as possible without blocking
+		/// @return false on a socket error
+		bool flush(SocketClient &client);
+
+		/// Check if there are still messages (or parts of it) to send
+		bool hasPending() const;
+
+		/// Drop all queued messages, for instance when the connection is lost
+		void clear();
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		using Message = std::vector<unsigned char>;
+
+		struct QueuedMessage {
+			Message data;
+			DecryptStatistics *statistics;
+		};
+
+		/// Maximum amount of queued messages
+		static constexpr std::size_t MAX_MESSAGES = 512;
+		/// Maximum amount of messages send with one call
+		static constexpr std::size_t MAX_IOV = 64;
+		/// Amount of message buffers that are allocated in advance
+		static constexpr std::size_t PREALLOCATED_MESSAGES = 32;
+		static constexpr std::size_t PREALLOCATED_MESSAGE_SIZE = 1024;
+
+		mutable std::mutex _mutex;
+		std::deque<QueuedMessage> _queue;
+		std::vector<Message> _free;
+		/// Amount of bytes of the first message in the queue that are send already
+		std::size_t _offset;
+};
+
+}
+
+#endif // DECRYPT_DVBAPI_SEND_QUEUE_H_INCLUDE
@@ -25,12 +25,14 @@
 #include <base/XMLSupport.h>
 #include <input/InputSystem.h>
 #include <mpegts/Filter.h>
+#include <mpegts/PacketBuffer.h>
 
+#include <cstddef>
+#include <functional>
 #include <string>
 #include <utility>
 
 FW_DECL_NS0(TransportParamVector);
-FW_DECL_NS1(mpegts, PacketBuffer);
 
 FW_DECL_SP_NS1(input, Device);
 
@@ -40,6 +42,12 @@ namespace input {
 /// For example an frontend with DVB-S2 or File input etc.
 class Device :
 	public base::XMLSupport {
+	public:
+
+		/// Function called with the file descriptor of @see getDataAvailableFD
+		/// just before the device closes it
+		using FunctionCloseDataAvailableFD = std::function<void(int)>;
+
 		// =========================================================================
 		//  -- Constructors and destructor -----------------------------------------
 		// =========================================================================
@@ -66,10 +74,44 @@ class Device :
 		/// Check if there is data to be red from this device
 		virtual bool isDataAvailable() = 0;
 
+		/// Check if this device has a file descriptor that becomes readable when
+		/// data is available, so it can be read by a StreamReactor. Devices that
+		/// pace the reading themselves in @see isDataAvailable return false.
+		virtual bool hasDataAvailableFD() const {
+			return false;
+		}
+
+		/// Get the file descriptor that becomes readable when data is available
+		/// @return the file descriptor or -1 when there is none (yet)
+		virtual int getDataAvailableFD() const {
+			return -1;
+		}
+
+		/// Set the function to call just before the file descriptor of
+		/// @see getDataAvailableFD is closed, so it can be removed from epoll
+		void setCloseDataAvailableFD(FunctionCloseDataAvailableFD function) {
+			_closeDataAvailableFD = function;
+		}
+
 		/// Read the available data from this device
 		/// @param buffer this is the buffer were to wirite to
 		virtual bool readTSPackets(mpegts::PacketBuffer& buffer) = 0;
 
+		/// Read the available data from this device into a batch of consecutive
+		/// buffers. The first buffer may already contain a partial read, the
+		/// other buffers should be empty. The default implementation keeps on
+		/// reading single buffers until one of them could not be filled.
+		/// @param buffers points to the first buffer of the batch
+		/// @param count specifies the amount of buffers in this batch
+		/// @return the amount of buffers that are completely filled
+		virtual std::size_t readTSPacketBatch(mpegts::PacketBuffer* buffers, std::size_t count) {
+			std::size_t filled = 0;
+			while (filled < count && readTSPackets(buffers[filled])) {
+				++filled;
+			}
+			return filled;
+		}
+
 		/// Check the capability of this device
 		/// @param system specifies the input system that this device is capable of
 		virtual bool capableOf(input::InputSystem system) const = 0;
@@ -151,14 +193,29 @@ class Device :
 			return _streamID;
 		}
 
+	protected:
+
+		/// Call this just before closing the file descriptor of @see getDataAvailableFD
+		void closingDataAvailableFD(const int fd) const {
+			if (_closeDataAvailableFD && fd != -1) {
+				_closeDataAvailableFD(fd);
+			}
+		}
+
 		// =========================================================================
 		// -- Data members ---------------------------------------------------------
 		// =========================================================================
+	public:
+
+		/// The maximum amount of buffers that can be requested with @see readTSPacketBatch
+		static constexpr std::size_t MAX_READ_BATCH_SIZE = 32;
+
 	protected:
 
 		FeIndex _index;
 		FeID _feID;
 		StreamID _streamID;
+		FunctionCloseDataAvailableFD _closeDataAvailableFD;
 };
 
 }
@@ -152,6 +152,12 @@ bool TSReader::readTSPackets(mpegts::PacketBuffer& buffer) {
 	return buffer.full();
 }
 
+std::size_t TSReader::readTSPacketBatch(mpegts::PacketBuffer* buffers, std::size_t UNUSED(count)) {
+	// Only read one buffer per call, because isDataAvailable() is pacing
+	// the reading according to the PCR
+	return readTSPackets(buffers[0]) ? 1 : 0;
+}
+
 bool TSReader::capableOf(const input::InputSystem system) const {
 	if (_enableUnsecureFrontends) {
 		return system == input::InputSystem::CHILDPIPE;
@@ -0,0 +1,244 @@
+/* DMXBufferQueue.cpp
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <input/dvb/DMXBufferQueue.h>
+
+#include <Log.h>
+#include <mpegts/PacketBuffer.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <linux/dvb/dmx.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+
+namespace input::dvb {
+
+// =============================================================================
+// -- Static const data --------------------------------------------------------
+// =============================================================================
+
+/// Each kernel buffer carries a multiple of the TS packets of one PacketBuffer
+static constexpr std::size_t KERNEL_BUFFER_SIZE = mpegts::PacketBuffer::MTU_MAX_TS_PACKET_SIZE * 64;
+static constexpr std::size_t MIN_KERNEL_BUFFERS = 8;
+static constexpr std::size_t MAX_KERNEL_BUFFERS = 32;
+
+// =============================================================================
+// -- Queue / Lease ------------------------------------------------------------
+// =============================================================================
+
+/// The mapped kernel buffers, shared with all leases so the mappings outlive
+/// a closed DMX as long as a PacketBuffer is still using them.
+struct DMXBufferQueue::Queue {
+	~Queue() {
+		for (const auto &[ptr, length] : mappings) {
+			::munmap(ptr, length);
+		}
+	}
+
+	/// Queue the buffer again, unless the queue is released. This can be
+	/// called from any thread, so it is serialized with @see close
+	void enqueue(const unsigned int index) {
+#ifdef DMX_QBUF
+		std::lock_guard<std::mutex> lock(mutex);
+		if (fd == -1) {
+			return;
+		}
+		struct dmx_buffer buf{};
+		buf.index = index;
+		if (::ioctl(fd, DMX_QBUF, &buf) != 0) {
+			SI_LOG_PERROR("Frontend: @#1, Failed to queue DMX buffer @#2", feID, index);
+		}
+#else
+		(void)index;
+#endif
+	}
+
+	/// Do not queue any buffer again, after this the DMX can be closed
+	void close() {
+		std::lock_guard<std::mutex> lock(mutex);
+		fd = -1;
+	}
+
+	FeID feID;
+	/// Guards @c fd, so it is not closed while a buffer is queued
+	std::mutex mutex;
+	int fd = -1;
+	std::vector<std::pair<unsigned char*, std::size_t>> mappings;
+};
+
+/// One dequeued kernel buffer, queued again when the last user is gone
+struct DMXBufferQueue::Lease {
+	Lease(std::shared_ptr<Queue> q, const unsigned int i) : queue(std::move(q)), index(i) {}
+
+	~Lease() {
+		queue->enqueue(index);
+	}
+
+	std::shared_ptr<Queue> queue;
+	unsigned int index;
+};
+
+// =============================================================================
+// -- Constructors and destructor ----------------------------------------------
+// =============================================================================
+
+DMXBufferQueue::~DMXBufferQueue() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	releaseLocked();
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+bool DMXBufferQueue::setup(const FeID id, const int fd, const std::size_t bufferSize) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	releaseLocked();
+	_feID = id;
+#ifdef DMX_REQBUFS
+	struct dmx_requestbuffers req{};
+	req.count = std::clamp(bufferSize / KERNEL_BUFFER_SIZE, MIN_KERNEL_BUFFERS, MAX_KERNEL_BUFFERS);
+	req.size = KERNEL_BUFFER_SIZE;
+	if (::ioctl(fd, DMX_REQBUFS, &req) != 0 || req.count == 0) {
+		SI_LOG_PERROR("Frontend: @#1, DMX_REQBUFS not supported, using read()", _feID);
+		return false;
+	}
+	auto queue = std::make_shared<Queue>();
+	queue->feID = _feID;
+	for (unsigned int i = 0; i < req.count; ++i) {
+		struct dmx_buffer buf{};
+		buf.index = i;
+		if (::ioctl(fd, DMX_QUERYBUF, &buf) != 0) {
+			SI_LOG_PERROR("Frontend: @#1, Failed DMX_QUERYBUF for buffer @#2", _feID, i);
+			return false;
+		}
+		void *ptr = ::mmap(nullptr, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, buf.offset);
+		if (ptr == MAP_FAILED) {
+			SI_LOG_PERROR("Frontend: @#1, Failed to mmap DMX buffer @#2", _feID, i);
+			return false;
+		}
+		queue->mappings.emplace_back(static_cast<unsigned char *>(ptr), buf.length);
+	}
+	// Queue all buffers before the filter is started with DMX_START
+	queue->fd = fd;
+	for (unsigned int i = 0; i < req.count; ++i) {
+		struct dmx_buffer buf{};
+		buf.index = i;
+		if (::ioctl(fd, DMX_QBUF, &buf) != 0) {
+			SI_LOG_PERROR("Frontend: @#1, Failed DMX_QBUF for buffer @#2", _feID, i);
+			queue->close();
+			return false;
+		}
+	}
+	_queue = std::move(queue);
+	_active.store(true, std::memory_order_release);
+	SI_LOG_INFO("Frontend: @#1, Using @#2 mmap DMX buffers of @#3 Bytes", _feID, req.count, req.size);
+	return true;
+#else
+	(void)fd;
+	(void)bufferSize;
+	SI_LOG_INFO("Frontend: @#1, DMX_REQBUFS not available, using read()", _feID);
+	return false;
+#endif
+}
+
+void DMXBufferQueue::release() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	releaseLocked();
+}
+
+void DMXBufferQueue::releaseLocked() {
+	_active.store(false, std::memory_order_release);
+	if (_queue) {
+		// Do not queue any buffer again, the DMX will be closed
+		_queue->close();
+	}
+	_lease.reset();
+	_queue.reset();
+	_data = nullptr;
+	_size = 0;
+	_offset = 0;
+}
+
+bool DMXBufferQueue::dequeue() {
+	// Give up the current kernel buffer, it is queued again when the last
+	// PacketBuffer attached to it is reset
+	_lease.reset();
+	_data = nullptr;
+	_size = 0;
+	_offset = 0;
+#ifdef DMX_DQBUF
+	if (!_queue) {
+		return false;
+	}
+	struct dmx_buffer buf{};
+	if (::ioctl(_queue->fd, DMX_DQBUF, &buf) != 0) {
+		if (errno != EAGAIN) {
+			SI_LOG_PERROR("Frontend: @#1, Failed DMX_DQBUF", _feID);
+		}
+		return false;
+	}
+	if (buf.index >= _queue->mappings.size()) {
+		SI_LOG_ERROR("Frontend: @#1, DMX_DQBUF returned unknown buffer @#2", _feID, buf.index);
+		return false;
+	}
+	if ((buf.flags & DMX_BUFFER_PKT_COUNTER_MISMATCH) != 0) {
+		SI_LOG_DEBUG("Frontend: @#1, DMX buffer @#2 reported continuity counter mismatch", _feID, buf.index);
+	}
+	_lease = std::make_shared<Lease>(_queue, buf.index);
+	_data = _queue->mappings[buf.index].first;
+	_size = std::min<std::size_t>(buf.bytesused, _queue->mappings[buf.index].second);
+	return true;
+#else
+	return false;
+#endif
+}
+
+std::size_t DMXBufferQueue::readTSPacketBatch(mpegts::PacketBuffer* buffers, const std::size_t count) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	std::size_t filled = 0;
+	while (filled < count) {
+		if (_offset >= _size && !dequeue()) {
+			break;
+		}
+		mpegts::PacketBuffer &buffer = buffers[filled];
+		const std::size_t available = _size - _offset;
+		if (buffer.empty() && available >= mpegts::PacketBuffer::getMaxBufferSize()) {
+			// Zero copy, just use this part of the kernel buffer
+			buffer.attachExternalData(_data + _offset, _lease);
+			_offset += mpegts::PacketBuffer::getMaxBufferSize();
+		} else {
+			// Not enough left for a complete PacketBuffer, so copy what is left
+			const std::size_t size = std::min(available, buffer.getAmountOfBytesToWrite());
+			std::memcpy(buffer.getWriteBufferPtr(), _data + _offset, size);
+			buffer.addAmountOfBytesWritten(size);
+			_offset += size;
+		}
+		if (buffer.full()) {
+			++filled;
+		}
+	}
+	return filled;
+}
+
+}
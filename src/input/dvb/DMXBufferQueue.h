@@ -0,0 +1,110 @@
+/* DMXBufferQueue.h
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef INPUT_DVB_DMX_BUFFER_QUEUE_H_INCLUDE
+#define INPUT_DVB_DMX_BUFFER_QUEUE_H_INCLUDE INPUT_DVB_DMX_BUFFER_QUEUE_H_INCLUDE
+
+#include <Defs.h>
+#include <FwDecl.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+FW_DECL_NS1(mpegts, PacketBuffer);
+
+namespace input::dvb {
+
+/// The class @c DMXBufferQueue maps the kernel demux buffers (DMX_REQBUFS) into
+/// user space, so the TS packets can be attached to PacketBuffers instead of
+/// copying them with read(). A kernel buffer is queued again when the last
+/// PacketBuffer using it is reset. The reader uses it while a request can
+/// set it up or release it, so these are serialized with a mutex.
+class DMXBufferQueue {
+		// =========================================================================
+		// -- Constructors and destructor ------------------------------------------
+		// =========================================================================
+	public:
+
+		DMXBufferQueue() = default;
+
+		virtual ~DMXBufferQueue();
+
+		DMXBufferQueue(const DMXBufferQueue&) = delete;
+
+		DMXBufferQueue& operator=(const DMXBufferQueue&) = delete;
+
+		// =========================================================================
+		//  -- Other member functions ----------------------------------------------
+		// =========================================================================
+	public:
+
+		/// Request, map and queue the kernel buffers of the opened DMX, call it
+		/// before the filter is started
+		/// @param id specifies the frontend ID used for logging
+		/// @param fd specifies the file descriptor of the opened DMX
+		/// @param bufferSize specifies the total amount of bytes to request
+		/// @return false if the driver does not support this, then use read()
+		bool setup(FeID id, int fd, std::size_t bufferSize);
+
+		/// Stop using the kernel buffers. Buffers still attached to a
+		/// PacketBuffer stay mapped until these are reset, but are not queued
+		/// again. After this the DMX can be closed.
+		void release();
+
+		/// Check if the kernel buffers are mapped and queued
+		bool isActive() const noexcept {
+			return _active.load(std::memory_order_acquire);
+		}
+
+		/// Fill the requested buffers with the dequeued kernel buffers
+		/// @see input::Device::readTSPacketBatch
+		std::size_t readTSPacketBatch(mpegts::PacketBuffer* buffers, std::size_t count);
+
+	private:
+
+		/// Stop using the kernel buffers, @c _mutex should be locked
+		void releaseLocked();
+
+		/// Dequeue the next filled kernel buffer, if there is one
+		bool dequeue();
+
+		// =========================================================================
+		// -- Data members ---------------------------------------------------------
+		// =========================================================================
+	private:
+
+		struct Queue;
+		struct Lease;
+
+		/// Guards all below, between the reader and setup/release
+		std::mutex _mutex;
+		std::atomic_bool _active{false};
+		FeID _feID;
+		std::shared_ptr<Queue> _queue;
+		std::shared_ptr<void> _lease;
+		unsigned char* _data = nullptr;
+		std::size_t _size = 0;
+		std::size_t _offset = 0;
+};
+
+}
+
+#endif // INPUT_DVB_DMX_BUFFER_QUEUE_H_INCLUDE
@@ -32,6 +32,9 @@
 #include <input/dvb/delivery/DVBT.h>
 #include <input/dvb/delivery/DiSEqc.h>
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
 #include <chrono>
 #include <thread>
 
@@ -44,6 +47,7 @@
 #include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 #include <base/StopWatch.h>
 
@@ -57,6 +61,8 @@ static constexpr unsigned int DEFAULT_DVR_BUFFER_SIZE       = 3;
 static constexpr unsigned int MAX_DVR_BUFFER_SIZE           = 3 * 10;
 static constexpr unsigned long MAX_WAIT_ON_LOCK_TIMEOUT     = 3500;
 static constexpr unsigned long DEFAULT_WAIT_ON_LOCK_TIMEOUT = 1000;
+// Read the status again after this time, for drivers without lock events
+static constexpr unsigned long LOCK_STATUS_INTERVAL         = 100;
 
 // =============================================================================
 // -- Constructors and destructor ----------------------------------------------
@@ -84,7 +90,10 @@ Frontend::Frontend(
 	_dvbc(0),
 	_dvbc2(0),
 	_dvrBufferSizeMB(DEFAULT_DVR_BUFFER_SIZE),
-	_waitOnLockTimeout(DEFAULT_WAIT_ON_LOCK_TIMEOUT) {
+	_dvrMmap(false),
+	_waitOnLockTimeout(DEFAULT_WAIT_ON_LOCK_TIMEOUT),
+	_fastRetune(true),
+	_shareTransponder(false) {
 	snprintf(_fe_info.name, sizeof(_fe_info.name), "Not Set");
 	setupFrontend();
 #if FULL_DVB_API_VERSION >= 0x050A
@@ -198,8 +207,14 @@ void Frontend::doAddToXML(std::string &xml) const {
 	ADD_XML_ELEMENT(xml, "dvbversion", HEX(_dvbVersion, 4));
 
 	ADD_XML_NUMBER_INPUT(xml, "dvrbuffer", _dvrBufferSizeMB, 0, MAX_DVR_BUFFER_SIZE);
+	ADD_XML_CHECKBOX(xml, "dvrMmap", (_dvrMmap ? "true" : "false"));
+	ADD_XML_ELEMENT(xml, "dvrMmapActive", (_dmxBufferQueue.isActive() ? "Yes" : "No"));
 	ADD_XML_NUMBER_INPUT(xml, "waitOnLockTimeout", _waitOnLockTimeout, 0, MAX_WAIT_ON_LOCK_TIMEOUT);
+	ADD_XML_CHECKBOX(xml, "fastRetune", (_fastRetune ? "true" : "false"));
 	ADD_XML_CHECKBOX(xml, "forceOldStyleStatus", (_oldApiCallStats ? "true" : "false"));
+	ADD_XML_CHECKBOX(xml, "shareTransponder", (_shareTransponder ? "true" : "false"));
+
+	_tuneStatistics.addToXML(xml);
 
 #ifdef LIBDVBCSA
 	_dvbapiData.addToXML(xml);
@@ -222,13 +237,22 @@ void Frontend::doFromXML(const std::string &xml) {
 		_dvrBufferSizeMB = (newSize < MAX_DVR_BUFFER_SIZE) ?
 			newSize : DEFAULT_DVR_BUFFER_SIZE;
 	}
+	if (findXMLElement(xml, "dvrMmap.value", element)) {
+		_dvrMmap = (element == "true") ? true : false;
+	}
 	if (findXMLElement(xml, "waitOnLockTimeout.value", element)) {
 		const unsigned int c = std::stoi(element);
 		_waitOnLockTimeout = (c < MAX_WAIT_ON_LOCK_TIMEOUT) ? c : MAX_WAIT_ON_LOCK_TIMEOUT;
 	}
+	if (findXMLElement(xml, "fastRetune.value", element)) {
+		_fastRetune = (element == "true") ? true : false;
+	}
 	if (findXMLElement(xml, "forceOldStyleStatus.value", element)) {
 		_oldApiCallStats = (element == "true") ? true : false;
 	}
+	if (findXMLElement(xml, "shareTransponder.value", element)) {
+		_shareTransponder = (element == "true") ? true : false;
+	}
 	for (std::size_t i = 0; i < _deliverySystem.size(); ++i) {
 		const std::string deliverySystem = StringConverter::stringFormat("deliverySystem@#1", i);
 		if (findXMLElement(xml, deliverySystem, element)) {
@@ -238,6 +262,9 @@ void Frontend::doFromXML(const std::string &xml) {
 	if (findXMLElement(xml, "transformation", element)) {
 		_transform.fromXML(element);
 	}
+#ifdef LIBDVBCSA
+	_dvbapiData.fromXML(xml);
+#endif
 	_frontendData.fromXML(xml);
 }
 
@@ -275,9 +302,15 @@ bool Frontend::isDataAvailable() {
 }
 
 bool Frontend::readTSPackets(mpegts::PacketBuffer& buffer) {
+	if (_dmxBufferQueue.isActive()) {
+		return readTSPacketBatch(&buffer, 1) == 1;
+	}
 	// try read maximum amount of bytes from DMX
 	const auto readSize = ::read(_fd_dmx, buffer.getWriteBufferPtr(), buffer.getAmountOfBytesToWrite());
 	if (readSize > 0) {
+		if (_tuneStatistics.isWaitingForFirstPacket()) {
+			firstPacketRead();
+		}
 		buffer.addAmountOfBytesWritten(readSize);
 		if (buffer.full()) {
 			_frontendData.getFilter().filterData(_feID, buffer, false);
@@ -292,6 +325,52 @@ bool Frontend::readTSPackets(mpegts::PacketBuffer& buffer) {
 	return false;
 }
 
+std::size_t Frontend::readTSPacketBatch(mpegts::PacketBuffer* buffers, std::size_t count) {
+	if (_dmxBufferQueue.isActive()) {
+		// Zero copy, the buffers are attached to the mapped kernel buffers
+		const std::size_t filled = _dmxBufferQueue.readTSPacketBatch(buffers, count);
+		if (filled > 0) {
+			if (_tuneStatistics.isWaitingForFirstPacket()) {
+				firstPacketRead();
+			}
+			_frontendData.getFilter().filterData(_feID, buffers, filled, false);
+		}
+		return filled;
+	}
+	count = std::min(count, MAX_READ_BATCH_SIZE);
+	// Scatter one read from DMX over all the buffers of this batch
+	std::array<iovec, MAX_READ_BATCH_SIZE> iov{};
+	for (std::size_t i = 0; i < count; ++i) {
+		iov[i].iov_base = buffers[i].getWriteBufferPtr();
+		iov[i].iov_len = buffers[i].getAmountOfBytesToWrite();
+	}
+	const auto readSize = ::readv(_fd_dmx, iov.data(), count);
+	if (readSize > 0) {
+		if (_tuneStatistics.isWaitingForFirstPacket()) {
+			firstPacketRead();
+		}
+		std::size_t remaining = readSize;
+		std::size_t filled = 0;
+		for (; filled < count && remaining > 0; ++filled) {
+			const std::size_t size = std::min(remaining, iov[filled].iov_len);
+			buffers[filled].addAmountOfBytesWritten(size);
+			remaining -= size;
+			if (!buffers[filled].full()) {
+				break;
+			}
+		}
+		if (filled > 0) {
+			_frontendData.getFilter().filterData(_feID, buffers, filled, false);
+		}
+		return filled;
+	} else if (readSize < 0) {
+		SI_LOG_PERROR("Frontend: @#1, Error reading data..", _feID);
+	} else {
+		SI_LOG_ERROR("Frontend: @#1, Error reading data: 0 Bytes available..", _feID);
+	}
+	return 0;
+}
+
 bool Frontend::capableOf(const input::InputSystem system) const {
 	for (const input::dvb::delivery::UpSystem& deliverySystem : _deliverySystem) {
 		if (deliverySystem->isCapableOf(system)) {
@@ -301,10 +380,13 @@ bool Frontend::capableOf(const input::InputSystem system) const {
 	return false;
 }
 
-bool Frontend::capableToShare(const TransportParamVector& UNUSED(params)) const {
-	// @TODO: Check if the same "channel" is requested for sharing this frontend
-	//        maybe check if sharing is allowed
-	return false;
+bool Frontend::capableToShare(const TransportParamVector& params) const {
+	// Only share when the same transponder is requested, transformed requests
+	// are not shared because they are translated to other tuning parameters
+	if (!_shareTransponder || !_tuned || _transform.isEnabled()) {
+		return false;
+	}
+	return _frontendData.isSameTransponder(params);
 }
 
 bool Frontend::capableToTransform(const TransportParamVector& params) const {
@@ -456,9 +538,12 @@ bool Frontend::update() {
 		// Close active PIDs
 		closeActivePIDFilters();
 		closeDMX();
-		closeFE();
-		// After close wait a moment before opening it again
-		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		// With a fast retune the frontend stays open and is just tuned again
+		if (!_fastRetune) {
+			closeFE();
+			// After close wait a moment before opening it again
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		}
 	}
 
 	if (!setupAndTune()) {
@@ -553,11 +638,22 @@ void Frontend::updatePIDFilters() {
 				pesFilter.input    = DMX_IN_FRONTEND;
 				pesFilter.output   = DMX_OUT_TSDEMUX_TAP;
 				pesFilter.pes_type = DMX_PES_OTHER;
-				pesFilter.flags    = DMX_IMMEDIATE_START;
+				pesFilter.flags    = 0;
 				if (::ioctl(_fd_dmx, DMX_SET_PES_FILTER, &pesFilter) != 0) {
 					SI_LOG_PERROR("Frontend: @#1, Failed to set DMX_SET_PES_FILTER for PID: @#2", _feID, PID(p));
 					return false;
 				}
+				// Try mmap capture, if not supported we fall back to read(). Set it up
+				// before starting the filter, so no data goes to the read() buffer
+				if (_dvrMmap) {
+					const std::size_t size = ((_dvrBufferSizeMB > 0) ?
+						_dvrBufferSizeMB : DEFAULT_DVR_BUFFER_SIZE) * 1024 * 1024;
+					_dmxBufferQueue.setup(_feID, _fd_dmx, size);
+				}
+				if (::ioctl(_fd_dmx, DMX_START) != 0) {
+					SI_LOG_PERROR("Frontend: @#1, Failed to DMX_START for PID: @#2", _feID, PID(p));
+					return false;
+				}
 			} else if (::ioctl(_fd_dmx, DMX_ADD_PID, &p) != 0) {
 				SI_LOG_PERROR("Frontend: @#1, Failed to set DMX_ADD_PID for PID: @#2", _feID, PID(p));
 				return false;
@@ -782,74 +878,121 @@ int Frontend::openDMX(const std::string &path) const {
 void Frontend::closeDMX() {
 	if (_fd_dmx != -1) {
 		SI_LOG_INFO("Frontend: @#1, Closing @#2 fd: @#3", _feID, _path_to_dmx, _fd_dmx);
+		// Waits for the reader and any buffer being queued, so the fd is not
+		// used anymore when it is closed
+		_dmxBufferQueue.release();
+		closingDataAvailableFD(_fd_dmx);
 		CLOSE_FD(_fd_dmx);
 	}
 }
 
-bool Frontend::tune() {
+bool Frontend::tune(long &diseqcTimeMS) {
+	diseqcTimeMS = -1;
 	const input::InputSystem delsys = _frontendData.getDeliverySystem();
 	for (input::dvb::delivery::UpSystem& system : _deliverySystem) {
 		if (system->isCapableOf(delsys)) {
-			return system->tune(_fd_fe, _frontendData);
+			const bool tuned = system->tune(_fd_fe, _frontendData);
+			diseqcTimeMS = system->getDiSEqcTimeMS();
+			return tuned;
 		}
 	}
 	return false;
 }
 
 bool Frontend::setupAndTune() {
-	if (!_tuned) {
-		base::StopWatch sw;
-		// Check if we have already opened a FE
-		if (_fd_fe == -1) {
-			sw.start();
-			_fd_fe = openFE(_path_to_fe, false);
-			if (_fd_fe < 0) {
-				const unsigned long openFETime = sw.getIntervalMS();
-				SI_LOG_INFO("Frontend: @#1, Fail to open @#2 for Read/Write with fd: @#3 (@#4 ms)", _feID, _path_to_fe, _fd_fe, openFETime);
-				_fd_fe = -1;
-				return false;
-			}
-			const unsigned long openFETime = sw.getIntervalMS();
-			SI_LOG_INFO("Frontend: @#1, Opened @#2 for Read/Write with fd: @#3 (@#4 ms)", _feID, _path_to_fe, _fd_fe, openFETime);
+	if (_tuned) {
+		return true;
+	}
+	_tuneStatistics.tuneStarted(_fd_fe != -1);
+	base::StopWatch sw;
+	// Check if we have already opened a FE
+	long openFETime = -1;
+	if (_fd_fe == -1) {
+		sw.start();
+		_fd_fe = openFE(_path_to_fe, false);
+		openFETime = sw.getIntervalMS();
+		if (_fd_fe < 0) {
+			SI_LOG_INFO("Frontend: @#1, Fail to open @#2 for Read/Write with fd: @#3 (@#4 ms)", _feID, _path_to_fe, _fd_fe, openFETime);
+			_fd_fe = -1;
+			return false;
 		}
-		// try tuning
-		if (!tune()) {
+		SI_LOG_INFO("Frontend: @#1, Opened @#2 for Read/Write with fd: @#3 (@#4 ms)", _feID, _path_to_fe, _fd_fe, openFETime);
+		_tuneStatistics.opened(openFETime);
+	}
+	// try tuning
+	sw.start();
+	long diseqcTime = -1;
+	if (!tune(diseqcTime)) {
+		return false;
+	}
+	const unsigned long tuneTime = sw.getIntervalMS() - ((diseqcTime > 0) ? diseqcTime : 0);
+	if (diseqcTime >= 0) {
+		_tuneStatistics.diseqcSent(diseqcTime);
+	}
+	_tuneStatistics.tuned(tuneTime);
+	_tuned = true;
+	SI_LOG_INFO("Frontend: @#1, Tuned, waiting on lock...", _feID);
+
+	sw.start();
+	fe_status_t status = FE_TIMEDOUT;
+	const bool locked = waitOnLock(status);
+	const unsigned long lockTime = sw.getIntervalMS();
+	if (locked) {
+		// We are tuned now, add some tuning stats
+		_frontendData.setMonitorData(FE_HAS_LOCK, 100, 8, 0, 0);
+		_tuneStatistics.locked(lockTime);
+		SI_LOG_INFO("Frontend: @#1, Tuned and locked (FE status @#2)", _feID, HEX(status, 2));
+	} else {
+		_tuneStatistics.lockTimedOut();
+		SI_LOG_INFO("Frontend: @#1, Not locked yet   (FE status @#2, Timeout @#3 ms)...", _feID, HEX(status, 2), lockTime);
+	}
+	SI_LOG_INFO("Frontend: @#1, Tune phases: open @#2 ms, DiSEqC @#3 ms, tune @#4 ms, lock @#5 ms",
+		_feID, openFETime, diseqcTime, tuneTime, lockTime);
+	return _tuned;
+}
+
+bool Frontend::waitOnLock(fe_status_t &status) {
+	base::StopWatch sw;
+	sw.start();
+	for (;;) {
+		// The status is read as well, for drivers that do not report events
+		if (::ioctl(_fd_fe, FE_READ_STATUS, &status) != 0) {
+			SI_LOG_PERROR("Frontend: @#1, FE_READ_STATUS", _feID);
+		} else if (status & FE_HAS_LOCK) {
+			return true;
+		}
+		const unsigned long waitTime = sw.getIntervalMS();
+		if (waitTime >= _waitOnLockTimeout) {
 			return false;
 		}
-		_tuned = true;
-		SI_LOG_INFO("Frontend: @#1, Tuned, waiting on lock...", _feID);
-		std::this_thread::sleep_for(std::chrono::milliseconds(300));
-		if (sw.getIntervalMS() < _waitOnLockTimeout) {
-			std::this_thread::sleep_for(std::chrono::milliseconds(150));
-			// check if frontend is locked, if not try a few times (Untill TIMEOUT)
-			for (int i = 1;; ++i) {
-				fe_status_t status = FE_TIMEDOUT;
-				// first read status
-				if (::ioctl(_fd_fe, FE_READ_STATUS, &status) == 0) {
-					if (status & FE_HAS_LOCK) {
-						// We are tuned now, add some tuning stats
-						_frontendData.setMonitorData(FE_HAS_LOCK, 100, 8, 0, 0);
-						SI_LOG_INFO("Frontend: @#1, Tuned and locked (FE status @#2)", _feID, HEX(status, 2));
-						break;
-					}
-					if (i == 1) {
-						SI_LOG_INFO("Frontend: @#1, Not locked yet   (FE status @#2)...", _feID, HEX(status, 2));
+		// A status change of the frontend is reported as event (POLLPRI)
+		pollfd pfd;
+		pfd.fd = _fd_fe;
+		pfd.events = POLLPRI;
+		pfd.revents = 0;
+		const int timeout = std::min(_waitOnLockTimeout - waitTime, LOCK_STATUS_INTERVAL);
+		if (::poll(&pfd, 1, timeout) > 0 && (pfd.revents & POLLPRI) == POLLPRI) {
+			// Read all pending events, EOVERFLOW means some were lost
+			for (;;) {
+				struct dvb_frontend_event event{};
+				if (::ioctl(_fd_fe, FE_GET_EVENT, &event) == 0) {
+					if (event.status & FE_HAS_LOCK) {
+						status = event.status;
+						return true;
 					}
-				} else {
-					SI_LOG_PERROR("Frontend: @#1, FE_READ_STATUS", _feID);
-				}
-				const unsigned long waitTime = sw.getIntervalMS();
-				if (waitTime > _waitOnLockTimeout) {
-					SI_LOG_INFO("Frontend: @#1, Not locked yet   (Timeout @#2 ms)...", _feID, waitTime);
+				} else if (errno != EOVERFLOW) {
 					break;
 				}
-				std::this_thread::sleep_for(std::chrono::milliseconds(150));
 			}
-		} else {
-			SI_LOG_INFO("Frontend: @#1, Not locked yet   (Timeout @#2 ms)...", _feID, sw.getIntervalMS());
 		}
 	}
-	return _tuned;
+}
+
+void Frontend::firstPacketRead() {
+	const std::int64_t time = _tuneStatistics.firstPacketReceived();
+	if (time >= 0) {
+		SI_LOG_INFO("Frontend: @#1, First packet read @#2 ms after start of tuning", _feID, time);
+	}
 }
 
 }
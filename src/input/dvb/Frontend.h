@@ -25,7 +25,9 @@
 #include <input/Device.h>
 #include <input/Transformation.h>
 #include <input/dvb/delivery/System.h>
+#include <input/dvb/DMXBufferQueue.h>
 #include <input/dvb/FrontendData.h>
+#include <input/dvb/TuneStatistics.h>
 #ifdef LIBDVBCSA
 #include <input/dvb/FrontendDecryptInterface.h>
 #include <decrypt/dvbapi/ClientProperties.h>
@@ -108,17 +110,21 @@ class Frontend :
 			return _dvbapiData.getMaximumBatchSize();
 		}
 
-		virtual void decryptBatch() noexcept final {
-			return _dvbapiData.decryptBatch();
+		virtual bool isBatchDeadlineExpired() const noexcept final {
+			return _dvbapiData.isBatchDeadlineExpired();
 		}
 
-		virtual void setBatchData(unsigned char* ptr, unsigned int len,
-				unsigned int parity, unsigned char* originalPtr) noexcept final {
-			_dvbapiData.setBatchData(ptr, len, parity, originalPtr);
+		virtual void decryptBatch(decrypt::dvbapi::DecryptWorkerPool *pool) noexcept final {
+			return _dvbapiData.decryptBatch(pool);
 		}
 
-		virtual const dvbcsa_bs_key_s* getKey(unsigned int parity) const final {
-			return _dvbapiData.getKey(parity);
+		virtual void setBatchData(unsigned char* ptr, unsigned int len, unsigned int parity,
+				unsigned char* originalPtr, mpegts::PacketBuffer &buffer) noexcept final {
+			_dvbapiData.setBatchData(ptr, len, parity, originalPtr, buffer);
+		}
+
+		virtual bool hasKey(unsigned int parity) const noexcept final {
+			return _dvbapiData.hasKey(parity);
 		}
 
 		virtual void setKey(const unsigned char* cw, unsigned int parity, int index) final {
@@ -129,6 +135,10 @@ class Frontend :
 			_dvbapiData.setICAM(ecm, parity);
 		}
 
+		virtual decrypt::dvbapi::DecryptStatistics &getDecryptStatistics() noexcept final {
+			return _dvbapiData.getStatistics();
+		}
+
 		virtual void startOSCamFilterData(int pid, unsigned int demux, unsigned int filter,
 			const unsigned char* filterData, const unsigned char* filterMask) final;
 
@@ -189,8 +199,18 @@ class Frontend :
 
 		virtual bool isDataAvailable() final;
 
+		virtual bool hasDataAvailableFD() const final {
+			return true;
+		}
+
+		virtual int getDataAvailableFD() const final {
+			return _fd_dmx;
+		}
+
 		virtual bool readTSPackets(mpegts::PacketBuffer& buffer) final;
 
+		virtual std::size_t readTSPacketBatch(mpegts::PacketBuffer* buffers, std::size_t count) final;
+
 		virtual bool capableOf(InputSystem system) const final;
 
 		virtual bool capableToShare(const TransportParamVector& params) const final;
@@ -240,12 +260,23 @@ class Frontend :
 		///
 		void closeDMX();
 
-		///
-		bool tune();
+		/// Tune with the delivery system of the requested channel
+		/// @param diseqcTimeMS returns the time it took to send the DiSEqC,
+		/// or -1 if there was none
+		bool tune(long &diseqcTimeMS);
 
 		///
 		bool setupAndTune();
 
+		/// Wait until the frontend has a lock, it returns as soon as an event
+		/// or the status of the frontend reports it
+		/// @param status returns the last read status of the frontend
+		/// @return false if there was no lock within the timeout
+		bool waitOnLock(fe_status_t &status);
+
+		/// The first packet after tuning was read
+		void firstPacketRead();
+
 		// =========================================================================
 		// -- Data members ---------------------------------------------------------
 		// =========================================================================
@@ -274,8 +305,13 @@ class Frontend :
 		std::size_t _dvbc2;
 
 		unsigned long _dvrBufferSizeMB;
+		bool _dvrMmap;
+		input::dvb::DMXBufferQueue _dmxBufferQueue;
 		unsigned long _waitOnLockTimeout;
+		bool _fastRetune;
+		input::dvb::TuneStatistics _tuneStatistics;
 		bool _oldApiCallStats;
+		bool _shareTransponder;
 };
 
 }
@@ -454,6 +454,39 @@ std::string FrontendData::doAttributeDescribeString(const FeID id) const {
 //  -- Other member functions --------------------------------------------------
 // =============================================================================
 
+bool FrontendData::isSameTransponder(const TransportParamVector& params) const {
+	base::MutexLock lock(_mutex);
+	const double reqFreq = params.getDoubleParameter("freq");
+	if (reqFreq == -1.0 || reqFreq != _freq / 1000.0) {
+		return false;
+	}
+	const input::InputSystem msys = params.getMSYSParameter();
+	if (msys != input::InputSystem::UNDEFINED && msys != _delsys) {
+		return false;
+	}
+	const int sr = params.getIntParameter("sr");
+	if (sr != -1 && (sr * 1000) != _srate) {
+		return false;
+	}
+	const std::string pol = params.getParameter("pol");
+	if (!pol.empty() && pol[0] != Lnb::translatePolarizationToChar(_pol)) {
+		return false;
+	}
+	const int src = params.getIntParameter("src");
+	if (((src >= 1 && src <= 255) ? src : 1) != _src) {
+		return false;
+	}
+	const int isId = params.getIntParameter("isi");
+	if ((isId != -1 ? isId : NO_STREAM_ID) != _isId) {
+		return false;
+	}
+	const int plpId = params.getIntParameter("plp");
+	if ((plpId != -1 ? plpId : NO_STREAM_ID) != _plpId) {
+		return false;
+	}
+	return true;
+}
+
 uint32_t FrontendData::getFrequency() const {
 	base::MutexLock lock(_mutex);
 	return _freq;
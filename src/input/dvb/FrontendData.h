@@ -80,6 +80,10 @@ class FrontendData :
 		// =========================================================================
 	public:
 
+		/// Check if the requested tuning parameters are for the transponder
+		/// that is used now (freq, msys, sr, pol, src, isi and plp)
+		bool isSameTransponder(const TransportParamVector& params) const;
+
 		/// Get the frequency in Mhz
 		uint32_t getFrequency() const;
 
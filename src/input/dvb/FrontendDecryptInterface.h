@@ -23,7 +23,9 @@
 #include <Defs.h>
 #include <FwDecl.h>
 
-FW_DECL_NS0(dvbcsa_bs_key_s);
+FW_DECL_NS1(mpegts, PacketBuffer);
+FW_DECL_NS2(decrypt, dvbapi, DecryptStatistics);
+FW_DECL_NS2(decrypt, dvbapi, DecryptWorkerPool);
 
 FW_DECL_SP_NS1(mpegts, PMT);
 FW_DECL_SP_NS1(mpegts, SDT);
@@ -59,15 +61,18 @@ class FrontendDecryptInterface {
 		///
 		virtual unsigned int getMaximumBatchSize() const noexcept = 0;
 
-		///
-		virtual void decryptBatch() noexcept = 0;
+		/// Check if the (partial) decrypt batch waited longer then its deadline
+		virtual bool isBatchDeadlineExpired() const noexcept = 0;
+
+		/// Decrypt the batch, with the worker pool or directly when it is nullptr
+		virtual void decryptBatch(decrypt::dvbapi::DecryptWorkerPool *pool) noexcept = 0;
 
 		///
 		virtual void setBatchData(unsigned char* ptr, unsigned int len, unsigned int parity,
-			unsigned char* originalPtr) noexcept = 0;
+			unsigned char* originalPtr, mpegts::PacketBuffer &buffer) noexcept = 0;
 
-		///
-		virtual const dvbcsa_bs_key_s* getKey(unsigned int parity) const = 0;
+		/// Check if there is an active key for the requested parity
+		virtual bool hasKey(unsigned int parity) const noexcept = 0;
 
 		///
 		virtual void setKey(const unsigned char* cw, unsigned int parity, int index) = 0;
@@ -75,6 +80,9 @@ class FrontendDecryptInterface {
 		///
 		virtual void setICAM(unsigned char ecm, unsigned int parity) = 0;
 
+		/// Get the ECM/CW latency statistics of this Frontend
+		virtual decrypt::dvbapi::DecryptStatistics &getDecryptStatistics() noexcept = 0;
+
 		///
 		virtual void startOSCamFilterData(int pid, unsigned int demux, unsigned int filter,
 				   const unsigned char* filterData, const unsigned char* filterMask) = 0;
@@ -0,0 +1,69 @@
+/* TuneStatistics.cpp
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <input/dvb/TuneStatistics.h>
+
+#include <StringConverter.h>
+#include <base/XMLSupport.h>
+
+#include <chrono>
+
+namespace input::dvb {
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void TuneStatistics::addToXML(std::string &xml) const {
+	ADD_XML_ELEMENT(xml, "tuneCount", _tuneCount.load(std::memory_order_relaxed));
+	ADD_XML_ELEMENT(xml, "retuneCount", _retuneCount.load(std::memory_order_relaxed));
+	ADD_XML_ELEMENT(xml, "lockTimeoutCount", _lockTimeoutCount.load(std::memory_order_relaxed));
+	_open.addToXML(xml, "openLatency");
+	_diseqc.addToXML(xml, "diseqcLatency");
+	_tune.addToXML(xml, "tuneLatency");
+	_lock.addToXML(xml, "lockLatency");
+	_firstPacket.addToXML(xml, "firstPacketLatency");
+}
+
+void TuneStatistics::tuneStarted(const bool retune) noexcept {
+	_tuneCount.fetch_add(1, std::memory_order_relaxed);
+	if (retune) {
+		_retuneCount.fetch_add(1, std::memory_order_relaxed);
+	}
+	_tuneStartTime.store(now(), std::memory_order_relaxed);
+	_waitingForFirstPacket.store(true, std::memory_order_release);
+}
+
+std::int64_t TuneStatistics::firstPacketReceived() noexcept {
+	if (!_waitingForFirstPacket.exchange(false, std::memory_order_acquire)) {
+		return -1;
+	}
+	const std::int64_t start = _tuneStartTime.load(std::memory_order_relaxed);
+	const std::int64_t t = now();
+	const std::int64_t ms = (t >= start) ? t - start : 0;
+	_firstPacket.add(ms);
+	return ms;
+}
+
+std::int64_t TuneStatistics::now() noexcept {
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
@@ -0,0 +1,119 @@
+/* TuneStatistics.h
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef INPUT_DVB_TUNE_STATISTICS_H_INCLUDE
+#define INPUT_DVB_TUNE_STATISTICS_H_INCLUDE INPUT_DVB_TUNE_STATISTICS_H_INCLUDE
+
+#include <base/LatencyHistogram.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace input::dvb {
+
+/// The class @c TuneStatistics follows the time of each phase of a channel
+/// change of one frontend. The first packet is seen by the reader thread,
+/// so it is all lock-free.
+class TuneStatistics {
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		TuneStatistics() = default;
+
+		virtual ~TuneStatistics() = default;
+
+		TuneStatistics(const TuneStatistics&) = delete;
+
+		TuneStatistics& operator=(const TuneStatistics&) = delete;
+
+		// =====================================================================
+		// -- Other member functions -------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Add the statistics to @p xml
+		void addToXML(std::string &xml) const;
+
+		/// A channel change starts, so wait for its first packet again
+		/// @param retune specifies if the frontend stayed open
+		void tuneStarted(bool retune) noexcept;
+
+		/// The frontend was opened in @p ms
+		void opened(std::uint64_t ms) noexcept {
+			_open.add(ms);
+		}
+
+		/// The DiSEqC command(s) were send in @p ms
+		void diseqcSent(std::uint64_t ms) noexcept {
+			_diseqc.add(ms);
+		}
+
+		/// The tuning properties were set in @p ms
+		void tuned(std::uint64_t ms) noexcept {
+			_tune.add(ms);
+		}
+
+		/// The frontend did lock @p ms after it was tuned
+		void locked(std::uint64_t ms) noexcept {
+			_lock.add(ms);
+		}
+
+		/// The frontend did not lock within the timeout
+		void lockTimedOut() noexcept {
+			_lockTimeoutCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		/// Check if the first packet after a channel change is not read yet
+		bool isWaitingForFirstPacket() const noexcept {
+			return _waitingForFirstPacket.load(std::memory_order_relaxed);
+		}
+
+		/// The first packet after the channel change was read
+		/// @return the time in ms since the start of the channel change, or
+		/// -1 if it was already counted
+		std::int64_t firstPacketReceived() noexcept;
+
+	private:
+
+		/// Get the current time in ms
+		static std::int64_t now() noexcept;
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		std::atomic<std::int64_t> _tuneStartTime{0};
+		std::atomic_bool _waitingForFirstPacket{false};
+		std::atomic<std::uint64_t> _tuneCount{0};
+		std::atomic<std::uint64_t> _retuneCount{0};
+		std::atomic<std::uint64_t> _lockTimeoutCount{0};
+		base::LatencyHistogram _open;
+		base::LatencyHistogram _diseqc;
+		base::LatencyHistogram _tune;
+		base::LatencyHistogram _lock;
+		base::LatencyHistogram _firstPacket;
+};
+
+}
+
+#endif // INPUT_DVB_TUNE_STATISTICS_H_INCLUDE
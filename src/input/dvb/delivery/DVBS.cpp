@@ -22,6 +22,7 @@
 #include <Log.h>
 #include <StringConverter.h>
 #include <Utils.h>
+#include <base/StopWatch.h>
 #include <base/Tokenizer.h>
 #include <input/dvb/FrontendData.h>
 #include <input/dvb/delivery/DiSEqcEN50494.h>
@@ -146,6 +147,9 @@ namespace input::dvb::delivery {
 
 	bool DVBS::tune(const int feFD, const input::dvb::FrontendData &frontendData) {
 		SI_LOG_INFO("Frontend: @#1, Start tuning process for DVB-S(2)...", _feID);
+		_diseqcTimeMS = -1;
+		base::StopWatch sw;
+		sw.start();
 
 		std::string fePathDiseqc(_fePath);
 		int feFDDiseqc = feFD;
@@ -163,6 +167,7 @@ namespace input::dvb::delivery {
 			!_diseqc->sendDiseqc(feFDDiseqc, _feID, freq, frontendData.getDiSEqcSource() - 1, frontendData.getPolarization())) {
 			return false;
 		}
+		_diseqcTimeMS = sw.getIntervalMS();
 
 		if (_fbc.doSendDiSEqcViaRootTuner()) {
 			SI_LOG_INFO("Frontend: @#1, Closing @#2 with fd: @#3", _feID, fePathDiseqc, feFDDiseqc);
@@ -45,7 +45,8 @@ class System :
 			_index(index),
 			_feID(id),
 			_fePath(fePath),
-			_dvbVersion(dvbVersion) {}
+			_dvbVersion(dvbVersion),
+			_diseqcTimeMS(-1) {}
 
 		virtual ~System() = default;
 
@@ -65,6 +66,12 @@ class System :
 		///
 		virtual void teardown(int UNUSED(feFD)) const {}
 
+		/// Get the time it took to send the DiSEqC command(s) of the last tune
+		/// @return the time in ms, or -1 if this tune did not send any
+		long getDiSEqcTimeMS() const {
+			return _diseqcTimeMS;
+		}
+
 		// =======================================================================
 		// -- Data members -------------------------------------------------------
 		// =======================================================================
@@ -74,6 +81,7 @@ class System :
 		FeID _feID;
 		std::string _fePath;
 		unsigned int _dvbVersion;
+		long _diseqcTimeMS;
 };
 
 }
@@ -93,6 +93,8 @@ class TSReader :
 
 		virtual bool readTSPackets(mpegts::PacketBuffer& buffer) final;
 
+		virtual std::size_t readTSPacketBatch(mpegts::PacketBuffer* buffers, std::size_t count) final;
+
 		virtual bool capableOf(input::InputSystem msys) const final;
 
 		virtual bool capableToShare(const TransportParamVector& params) const final;
@@ -168,6 +168,7 @@ bool Streamer::update() {
 	if (_deviceData.hasDeviceFrequencyChanged()) {
 		_deviceData.resetDeviceFrequencyChanged();
 		closeActivePIDFilters();
+		closingDataAvailableFD(_udpMultiListen.getFD());
 		_udpMultiListen.closeFD();
 	}
 	if (_udpMultiListen.getFD() == -1) {
@@ -198,6 +199,7 @@ bool Streamer::teardown() {
 	closeActivePIDFilters();
 	_deviceData.initialize();
 	_transform.resetTransformFlag();
+	closingDataAvailableFD(_udpMultiListen.getFD());
 	_udpMultiListen.closeFD();
 	return true;
 }
@@ -92,6 +92,14 @@ class Streamer :
 
 		virtual bool isDataAvailable() final;
 
+		virtual bool hasDataAvailableFD() const final {
+			return true;
+		}
+
+		virtual int getDataAvailableFD() const final {
+			return _udpMultiListen.getFD();
+		}
+
 		virtual bool readTSPackets(mpegts::PacketBuffer& buffer) final;
 
 		virtual bool capableOf(input::InputSystem msys) const final;
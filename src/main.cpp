@@ -197,10 +197,17 @@ namespace {
 			"\t--http-path <path>            set root path of web/http pages\r\n" \
 			"\t--http-port <port>            set http port default 8875 (1024 - 65535)\r\n" \
 			"\t--rtsp-port <port>            set rtsp port default 554  ( 554 - 65535)\r\n" \
+			"\t--max-connections <number>    set maximum connections per HTTP/RTSP server default 100 (1 - 4096)\r\n" \
 			"\t--backtrace <file>            backtrace 'file'\r\n" \
 			"\t--ssdp-ttl <hops>             set the TTL that is used for SSDP server (1 - 15)\r\n" \
 			"\t--childpipe <number>          enabled number amount of Frontends 'Child PIPE - TS Reader' (0 - 25)\r\n" \
 			"\t--enable-unsecure-frontends   enable to use 'Child PIPE - TS Reader' in command directly\r\n" \
+			"\t--io-threads <number>         read all frontends with number amount of I/O threads (0 - 16)\r\n" \
+			"\t                              default 0 uses one reader thread per frontend\r\n" \
+			"\t--writer-threads <number>     send to all clients with number amount of writer threads (0 - 16)\r\n" \
+			"\t                              default 2, 0 lets the reader thread write to the clients\r\n" \
+			"\t--decrypt-threads <number>    decrypt all frontends with number amount of worker threads (0 - 16)\r\n" \
+			"\t                              default 0 lets the reader thread decrypt\r\n" \
 			"\t--no-daemon                   do NOT daemonize\r\n" \
 			"\t--no-ssdp                     do NOT advertise server\r\n", prog_name);
 	}
@@ -259,6 +266,42 @@ int main(int argc, char *argv[]) {
 					printUsage(argv[0]);
 					return EXIT_FAILURE;
 				}
+			} else if (strcmp(argv[i], "--io-threads") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					params.numberOfIOThreads = std::stoi(argv[i]);
+					if (params.numberOfIOThreads < 0 || params.numberOfIOThreads > 16) {
+						printUsage(argv[0]);
+						return EXIT_FAILURE;
+					}
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
+			} else if (strcmp(argv[i], "--writer-threads") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					params.numberOfWriterThreads = std::stoi(argv[i]);
+					if (params.numberOfWriterThreads < 0 || params.numberOfWriterThreads > 16) {
+						printUsage(argv[0]);
+						return EXIT_FAILURE;
+					}
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
+			} else if (strcmp(argv[i], "--decrypt-threads") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					params.numberOfDecryptThreads = std::stoi(argv[i]);
+					if (params.numberOfDecryptThreads < 0 || params.numberOfDecryptThreads > 16) {
+						printUsage(argv[0]);
+						return EXIT_FAILURE;
+					}
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
 			} else if (strcmp(argv[i], "--enable-unsecure-frontends") == 0) {
 				params.enableUnsecureFrontends = true;
 			} else if (strcmp(argv[i], "--app-data-path") == 0) {
@@ -298,6 +341,19 @@ int main(int argc, char *argv[]) {
 					printUsage(argv[0]);
 					return EXIT_FAILURE;
 				}
+			} else if (strcmp(argv[i], "--max-connections") == 0) {
+				if (i + 1 < argc) {
+					++i;
+					params.maxConnections = std::stoi(argv[i]);
+					if (params.maxConnections < Properties::MAX_CONNECTIONS_MIN ||
+					    params.maxConnections > Properties::MAX_CONNECTIONS_MAX) {
+						printUsage(argv[0]);
+						return EXIT_FAILURE;
+					}
+				} else {
+					printUsage(argv[0]);
+					return EXIT_FAILURE;
+				}
 			} else if (strcmp(argv[i], "--rtsp-port") == 0) {
 				if (i + 1 < argc) {
 					++i;
@@ -0,0 +1,251 @@
+/* CRC32.cpp
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/CRC32.h>
+
+#include <array>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#include <immintrin.h>
+	#define CRC32_CLMUL_X86
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRYPTO)
+	#include <arm_neon.h>
+	#include <sys/auxv.h>
+	#include <asm/hwcap.h>
+	#define CRC32_PMULL_ARM
+#endif
+
+namespace mpegts {
+
+namespace {
+
+	constexpr uint32_t POLYNOMIAL = 0x04C11DB7;
+
+	using CRC32Tables = std::array<std::array<uint32_t, 256>, 8>;
+
+	/// Table n gives the CRC of a byte followed by n zero bytes
+	constexpr CRC32Tables makeTables() {
+		CRC32Tables tables{};
+		for (uint32_t b = 0; b < 256; ++b) {
+			uint32_t crc = b << 24;
+			for (int i = 0; i < 8; ++i) {
+				crc = (crc & 0x80000000) ? ((crc << 1) ^ POLYNOMIAL) : (crc << 1);
+			}
+			tables[0][b] = crc;
+		}
+		for (std::size_t n = 1; n < tables.size(); ++n) {
+			for (std::size_t b = 0; b < 256; ++b) {
+				const uint32_t crc = tables[n - 1][b];
+				tables[n][b] = (crc << 8) ^ tables[0][crc >> 24];
+			}
+		}
+		return tables;
+	}
+
+	constexpr CRC32Tables globalCRC32Tables = makeTables();
+
+#if defined(CRC32_CLMUL_X86) || defined(CRC32_PMULL_ARM)
+	/// Get x^n mod P, used to fold the data with carry-less multiplication
+	constexpr uint64_t xPowMod(const unsigned int n) {
+		uint32_t r = 1;
+		for (unsigned int i = 0; i < n; ++i) {
+			r = (r & 0x80000000) ? ((r << 1) ^ POLYNOMIAL) : (r << 1);
+		}
+		return r;
+	}
+
+	// Fold 16 bytes over 16 or 64 bytes of following data
+	constexpr uint64_t K_FOLD16_HI = xPowMod(128 + 64);
+	constexpr uint64_t K_FOLD16_LO = xPowMod(128);
+	constexpr uint64_t K_FOLD64_HI = xPowMod(512 + 64);
+	constexpr uint64_t K_FOLD64_LO = xPowMod(512);
+
+	/// The minimal size to use the carry-less multiplication
+	constexpr std::size_t CLMUL_MIN_SIZE = 64;
+#endif
+
+}
+
+// =============================================================================
+//  -- Carry-less multiplication -----------------------------------------------
+// =============================================================================
+//
+// The data is handled as big polynomial (first bit is the highest degree) in
+// blocks of 16 bytes. Each block is folded into the next block(s), by
+// multiplying its two 64 bit halves with x^n mod P. What remains is one block
+// that has the same CRC as all of the folded data, and that one is calculated
+// with the tables.
+
+#if defined(CRC32_CLMUL_X86)
+
+__attribute__((target("pclmul,ssse3")))
+static inline __m128i loadBlock(const unsigned char *data) noexcept {
+	const __m128i reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), reverse);
+}
+
+__attribute__((target("pclmul,ssse3")))
+static inline __m128i foldBlock(const __m128i block, const __m128i k, const __m128i next) noexcept {
+	return _mm_xor_si128(next, _mm_xor_si128(
+		_mm_clmulepi64_si128(block, k, 0x11), _mm_clmulepi64_si128(block, k, 0x00)));
+}
+
+__attribute__((target("pclmul,ssse3")))
+static uint32_t updateCLMUL(const uint32_t crc, const unsigned char *data, std::size_t len) noexcept {
+	const __m128i k16 = _mm_set_epi64x(K_FOLD16_HI, K_FOLD16_LO);
+	// The current CRC is the same as XOR-ing it with the first 4 bytes
+	__m128i x0 = _mm_xor_si128(loadBlock(data), _mm_set_epi32(crc, 0, 0, 0));
+	data += 16;
+	len -= 16;
+	if (len >= 64 + 48) {
+		const __m128i k64 = _mm_set_epi64x(K_FOLD64_HI, K_FOLD64_LO);
+		__m128i x1 = loadBlock(data + 0);
+		__m128i x2 = loadBlock(data + 16);
+		__m128i x3 = loadBlock(data + 32);
+		data += 48;
+		len -= 48;
+		for (; len >= 64; data += 64, len -= 64) {
+			x0 = foldBlock(x0, k64, loadBlock(data + 0));
+			x1 = foldBlock(x1, k64, loadBlock(data + 16));
+			x2 = foldBlock(x2, k64, loadBlock(data + 32));
+			x3 = foldBlock(x3, k64, loadBlock(data + 48));
+		}
+		x0 = foldBlock(x0, k16, x1);
+		x0 = foldBlock(x0, k16, x2);
+		x0 = foldBlock(x0, k16, x3);
+	}
+	for (; len >= 16; data += 16, len -= 16) {
+		x0 = foldBlock(x0, k16, loadBlock(data));
+	}
+	const __m128i reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	unsigned char block[16];
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(block), _mm_shuffle_epi8(x0, reverse));
+	const uint32_t blockCRC = CRC32::updateSlicingBy8(0, block, sizeof(block));
+	return CRC32::updateSlicingBy8(blockCRC, data, len);
+}
+
+static bool hasCLMUL() noexcept {
+	static const bool clmul = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+	return clmul;
+}
+
+#elif defined(CRC32_PMULL_ARM)
+
+static inline uint8x16_t loadBlock(const unsigned char *data) noexcept {
+	const uint8x16_t block = vrev64q_u8(vld1q_u8(data));
+	return vextq_u8(block, block, 8);
+}
+
+static inline uint8x16_t foldBlock(const uint8x16_t block, const poly64x2_t k, const uint8x16_t next) noexcept {
+	const poly64x2_t b = vreinterpretq_p64_u8(block);
+	const poly128_t hi = vmull_high_p64(b, k);
+	const poly128_t lo = vmull_p64(vgetq_lane_p64(b, 0), vgetq_lane_p64(k, 0));
+	return veorq_u8(next, veorq_u8(vreinterpretq_u8_p128(hi), vreinterpretq_u8_p128(lo)));
+}
+
+static inline poly64x2_t makeConstant(const uint64_t hi, const uint64_t lo) noexcept {
+	return vcombine_p64(vcreate_p64(lo), vcreate_p64(hi));
+}
+
+static uint32_t updateCLMUL(const uint32_t crc, const unsigned char *data, std::size_t len) noexcept {
+	const poly64x2_t k16 = makeConstant(K_FOLD16_HI, K_FOLD16_LO);
+	// The current CRC is the same as XOR-ing it with the first 4 bytes
+	uint8x16_t x0 = veorq_u8(loadBlock(data),
+		vreinterpretq_u8_u32(vsetq_lane_u32(crc, vdupq_n_u32(0), 3)));
+	data += 16;
+	len -= 16;
+	if (len >= 64 + 48) {
+		const poly64x2_t k64 = makeConstant(K_FOLD64_HI, K_FOLD64_LO);
+		uint8x16_t x1 = loadBlock(data + 0);
+		uint8x16_t x2 = loadBlock(data + 16);
+		uint8x16_t x3 = loadBlock(data + 32);
+		data += 48;
+		len -= 48;
+		for (; len >= 64; data += 64, len -= 64) {
+			x0 = foldBlock(x0, k64, loadBlock(data + 0));
+			x1 = foldBlock(x1, k64, loadBlock(data + 16));
+			x2 = foldBlock(x2, k64, loadBlock(data + 32));
+			x3 = foldBlock(x3, k64, loadBlock(data + 48));
+		}
+		x0 = foldBlock(x0, k16, x1);
+		x0 = foldBlock(x0, k16, x2);
+		x0 = foldBlock(x0, k16, x3);
+	}
+	for (; len >= 16; data += 16, len -= 16) {
+		x0 = foldBlock(x0, k16, loadBlock(data));
+	}
+	const uint8x16_t reversed = vrev64q_u8(x0);
+	unsigned char block[16];
+	vst1q_u8(block, vextq_u8(reversed, reversed, 8));
+	const uint32_t blockCRC = CRC32::updateSlicingBy8(0, block, sizeof(block));
+	return CRC32::updateSlicingBy8(blockCRC, data, len);
+}
+
+static bool hasCLMUL() noexcept {
+	static const bool pmull = (getauxval(AT_HWCAP) & HWCAP_PMULL) != 0;
+	return pmull;
+}
+
+#endif
+
+// =============================================================================
+//  -- Static member functions -------------------------------------------------
+// =============================================================================
+
+uint32_t CRC32::updateBytewise(uint32_t crc, const unsigned char *data, const std::size_t len) noexcept {
+	const auto &table = globalCRC32Tables[0];
+	for (std::size_t i = 0; i < len; ++i) {
+		crc = (crc << 8) ^ table[(crc >> 24) ^ data[i]];
+	}
+	return crc;
+}
+
+uint32_t CRC32::updateSlicingBy8(uint32_t crc, const unsigned char *data, std::size_t len) noexcept {
+	const auto &t = globalCRC32Tables;
+	for (; len >= 8; data += 8, len -= 8) {
+		crc ^= (static_cast<uint32_t>(data[0]) << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+		crc = t[7][crc >> 24] ^ t[6][(crc >> 16) & 0xFF] ^ t[5][(crc >> 8) & 0xFF] ^ t[4][crc & 0xFF] ^
+		      t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+	}
+	return updateBytewise(crc, data, len);
+}
+
+uint32_t CRC32::update(const uint32_t crc, const unsigned char *data, const std::size_t len) noexcept {
+#if defined(CRC32_CLMUL_X86) || defined(CRC32_PMULL_ARM)
+	if (len >= CLMUL_MIN_SIZE && hasCLMUL()) {
+		return updateCLMUL(crc, data, len);
+	}
+#endif
+	return updateSlicingBy8(crc, data, len);
+}
+
+const char *CRC32::getImplementationName() noexcept {
+#if defined(CRC32_CLMUL_X86)
+	if (hasCLMUL()) {
+		return "PCLMULQDQ";
+	}
+#elif defined(CRC32_PMULL_ARM)
+	if (hasCLMUL()) {
+		return "PMULL";
+	}
+#endif
+	return "Slicing-by-8";
+}
+
+}
@@ -0,0 +1,64 @@
+/* CRC32.h
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef MPEGTS_CRC32_H_INCLUDE
+#define MPEGTS_CRC32_H_INCLUDE MPEGTS_CRC32_H_INCLUDE
+
+#include <cstdint>
+#include <cstddef>
+
+namespace mpegts {
+
+/// The class @c CRC32 calculates the MPEG-2 CRC32 (polynomial 0x04C11DB7, not
+/// reflected) of the PSI/SI sections. It uses carry-less multiplication
+/// (PCLMULQDQ on x86 or PMULL on ARMv8) when the CPU supports it, else
+/// slicing-by-8.
+class CRC32 {
+	public:
+
+		/// The start value of the CRC
+		static constexpr uint32_t INIT = 0xFFFFFFFF;
+
+		/// Calculate the CRC32 of the data
+		/// @param data specifies the data to calculate the CRC of
+		/// @param len specifies the size of the data
+		static uint32_t calculate(const unsigned char *data, std::size_t len) noexcept {
+			return update(INIT, data, len);
+		}
+
+		/// Continue the CRC32 calculation with the next part of the data. The CRC
+		/// of a complete section, including its CRC field, is 0 when it is valid.
+		/// @param crc specifies the CRC of the previous part or INIT
+		/// @param data specifies the next part of the data
+		/// @param len specifies the size of the next part
+		static uint32_t update(uint32_t crc, const unsigned char *data, std::size_t len) noexcept;
+
+		/// Get the name of the used implementation
+		static const char *getImplementationName() noexcept;
+
+		/// @see update, but always with the byte at a time table lookup
+		static uint32_t updateBytewise(uint32_t crc, const unsigned char *data, std::size_t len) noexcept;
+
+		/// @see update, but always with slicing-by-8
+		static uint32_t updateSlicingBy8(uint32_t crc, const unsigned char *data, std::size_t len) noexcept;
+};
+
+}
+
+#endif // MPEGTS_CRC32_H_INCLUDE
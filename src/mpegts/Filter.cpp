@@ -41,6 +41,8 @@ Filter::Filter() {
 	_pcr = std::make_shared<PCR>();
 	_sdt = std::make_shared<SDT>();
 	_userPids = "0,1,16,17,18";
+	publishSnapshot();
+	_packetSnapshot = getSnapshot();
 }
 
 // =============================================================================
@@ -50,22 +52,23 @@ Filter::Filter() {
 void Filter::doAddToXML(std::string &xml) const {
 	ADD_XML_ELEMENT(xml, "pidcsv", getPidCSV());
 	ADD_XML_ELEMENT(xml, "totalCCErrors", getTotalCCErrors());
-	ADD_XML_CHECKBOX(xml, "filterPCR", (_filterPCR ? "true" : "false"));
+	ADD_XML_CHECKBOX(xml, "filterPCR", (_filterPCR.load() ? "true" : "false"));
 	ADD_XML_TEXT_INPUT(xml, "addUserPids", _userPids);
 
-	const SDT::Data sdtData = getSDTData()->getSDTDataFor(
+	const SpSnapshot snapshot = getSnapshot();
+	const SDT::Data sdtData = snapshot->sdt->getSDTDataFor(
 			getPMTData(0)->getProgramNumber());
 	ADD_XML_ELEMENT(xml, "channelname", sdtData.channelNameUTF8);
 	ADD_XML_ELEMENT(xml, "networkname", sdtData.networkNameUTF8);
 
-	ADD_XML_ELEMENT(xml, "pat", getPATData()->toXML());
+	ADD_XML_ELEMENT(xml, "pat", snapshot->pat->toXML());
 	ADD_XML_BEGIN_ELEMENT(xml, "pmtlist");
-		for (const auto& [pid, pmt] : _pmtMap) {
+		for (const auto& [pid, pmt] : snapshot->pmtMap) {
 			ADD_XML_ELEMENT(xml, "pmt", pmt->toXML());
 		}
 	ADD_XML_END_ELEMENT(xml, "pmtlist");
-	ADD_XML_ELEMENT(xml, "sdt", getSDTData()->toXML());
-	ADD_XML_ELEMENT(xml, "nit", getNITData()->toXML());
+	ADD_XML_ELEMENT(xml, "sdt", snapshot->sdt->toXML());
+	ADD_XML_ELEMENT(xml, "nit", snapshot->nit->toXML());
 }
 
 void Filter::doFromXML(const std::string &xml) {
@@ -93,12 +96,89 @@ void Filter::doFromXML(const std::string &xml) {
 
 void Filter::clear() {
 	base::MutexLock lock(_mutex);
-	_nit = std::make_shared<NIT>();
-	_pat = std::make_shared<PAT>();
-	_pcr = std::make_shared<PCR>();
-	_sdt = std::make_shared<SDT>();
-	_pmtMap.clear();
 	_pidTable.clear();
+	postCommand(FeID(), CLEAR_ALL);
+}
+
+void Filter::postCommand(const FeID feID, const int pid) {
+	{
+		std::lock_guard<std::mutex> lock(_commandMutex);
+		_commands.push_back({feID, pid});
+		_commandPending = true;
+	}
+	// Remove the tables that will be cleared, so readers do not use them anymore
+	std::lock_guard<std::mutex> lock(_snapshotMutex);
+	const SpSnapshot current = getSnapshot();
+	auto snapshot = std::make_shared<Snapshot>(*current);
+	if (pid == CLEAR_ALL) {
+		snapshot->pat = std::make_shared<PAT>();
+		snapshot->sdt = std::make_shared<SDT>();
+		snapshot->nit = std::make_shared<NIT>();
+		snapshot->pmtMap.clear();
+	} else if (pid == 0) {
+		snapshot->pat = std::make_shared<PAT>();
+	} else if (pid == 17) {
+		snapshot->sdt = std::make_shared<SDT>();
+	} else {
+		snapshot->pmtMap.erase(pid);
+	}
+	std::atomic_store(&_snapshot, SpSnapshot(std::move(snapshot)));
+}
+
+void Filter::handleCommands() {
+	std::vector<Command> commands;
+	{
+		std::lock_guard<std::mutex> lock(_commandMutex);
+		commands.swap(_commands);
+		_commandPending = false;
+	}
+	for (const Command &command : commands) {
+		const int pid = command.pid;
+		if (pid == CLEAR_ALL) {
+			_nit = std::make_shared<NIT>();
+			_pat = std::make_shared<PAT>();
+			_pcr = std::make_shared<PCR>();
+			_sdt = std::make_shared<SDT>();
+			_pmtMap.clear();
+		} else if (pid == 0) {
+			_pat = std::make_shared<PAT>();
+		} else if (pid == 17) {
+			_sdt = std::make_shared<SDT>();
+		} else if (_pmtMap.find(pid) != _pmtMap.end()) {
+			_pmtMap.erase(pid);
+		} else {
+			// Did we close the PCR Pid
+			for (const auto& [_, pmt] : _pmtMap) {
+				const int pcrPID = pmt->getPCRPid();
+				if (pcrPID > 0 && pcrPID == pid) {
+					const int pmtPID = pmt->getAssociatedPID();
+					SI_LOG_DEBUG("Frontend: @#1, Remove filter PID: @#2 - PCR Changed for PMT: @#3 - Clearing tables",
+						command.feID, PID(pid), PID(pmtPID));
+					_pcr = std::make_shared<PCR>();
+					break;
+				}
+			}
+		}
+	}
+	publishSnapshot();
+}
+
+void Filter::publishSnapshot() {
+	std::lock_guard<std::mutex> lock(_snapshotMutex);
+	if (_commandPending) {
+		return;
+	}
+	// Only publish collected tables, they are not changed anymore by the packet path
+	auto snapshot = std::make_shared<Snapshot>();
+	snapshot->pat = _pat->isCollected() ? _pat : std::make_shared<PAT>();
+	snapshot->sdt = _sdt->isCollected() ? _sdt : std::make_shared<SDT>();
+	snapshot->nit = _nit->isCollected() ? _nit : std::make_shared<NIT>();
+	for (const auto& [pid, pmt] : _pmtMap) {
+		if (pmt->isCollected()) {
+			snapshot->pmtMap.emplace(pid, pmt);
+		}
+	}
+	std::atomic_store(&_snapshot, SpSnapshot(std::move(snapshot)));
 }
 
 void Filter::parsePIDString(const FeID id, const std::string &reqPids, const bool add) {
@@ -134,16 +214,81 @@ void Filter::parsePIDString(const FeID id, const std::string &reqPids, const boo
 	}
 }
 
-void Filter::filterData(const FeID id, mpegts::PacketBuffer &buffer, const bool filter) {
+void Filter::parsePIDString(const FeID id, const std::string &reqPids,
+		const bool add, PidTable::PidSet &pids) const {
+	base::MutexLock lock(_mutex);
+	if (reqPids.find("all") != std::string::npos ||
+		reqPids.find("none") != std::string::npos) {
+		pids.reset();
+		if (reqPids.find("all") != std::string::npos) {
+			pids.set(PidTable::ALL_PIDS, add);
+		}
+	} else {
+		StringVector reqPidList = StringConverter::split(reqPids, ",");
+		if (add) {
+			const StringVector userPidList = StringConverter::split(_userPids, ",");
+			reqPidList.insert(reqPidList.end(), userPidList.begin(), userPidList.end());
+		}
+		for (const std::string& pid : reqPidList) {
+			try {
+				if (const auto p = std::stoi(pid); p >= 0 && p < PidTable::ALL_PIDS && (p > 18 || add)) {
+					pids.set(p, add);
+				}
+			} catch (const std::invalid_argument &) {
+				SI_LOG_ERROR("Frontend: @#1, Error, skipping PID: @#2", id, pid);
+			}
+		}
+	}
+}
+
+void Filter::setPIDs(const PidTable::PidSet &pids) {
 	base::MutexLock lock(_mutex);
+	// With all PIDs (full Transport Stream) the other PIDs are not used
+	const bool all = pids.test(PidTable::ALL_PIDS);
+	for (int pid = 0; pid < PidTable::ALL_PIDS; ++pid) {
+		_pidTable.setPID(pid, !all && pids.test(pid));
+	}
+	_pidTable.setAllPID(all);
+}
+
+void Filter::filterData(const FeID id, mpegts::PacketBuffer &buffer, const bool filter) {
+	if (_commandPending.load(std::memory_order_acquire)) {
+		handleCommands();
+	}
+	if (filterPackets(id, buffer, filter)) {
+		publishSnapshot();
+	}
+	_packetSnapshot = getSnapshot();
+}
+
+void Filter::filterData(const FeID id, mpegts::PacketBuffer *buffers,
+		const std::size_t count, const bool filter) {
+	if (_commandPending.load(std::memory_order_acquire)) {
+		handleCommands();
+	}
+	bool publish = false;
+	for (std::size_t i = 0; i < count; ++i) {
+		publish |= filterPackets(id, buffers[i], filter);
+	}
+	if (publish) {
+		publishSnapshot();
+	}
+	_packetSnapshot = getSnapshot();
+}
+
+bool Filter::filterPackets(const FeID id, mpegts::PacketBuffer &buffer, const bool filter) {
+	bool collected = false;
 	const std::size_t begin = buffer.getBeginOfUnFilteredPackets();
 	const std::size_t size = buffer.getNumberOfCompletedPackets();
+	// Copy it, marking packets for purging will invalidate the summary
+	const PacketSummary summary = buffer.getPacketSummary();
+	const unsigned int invalidMask = ~summary.syncMask | summary.teiMask | summary.nullMask;
 
 	for (std::size_t i = begin; i < size; ++i) {
 		const unsigned char* ptr = buffer.getTSPacketPtr(i);
-		const uint16_t pid = ((ptr[1] & 0x1f) << 8) | ptr[2];
+		const uint16_t pid = summary.pid[i];
 		// Check is this the beginning of the TS and no Transport error indicator and not a NULL packet
-		if (ptr[0] != 0x47 || (ptr[1] & 0x80) == 0x80 || pid == 0x1FFF || !_pidTable.isPIDOpened(pid)) {
+		if ((invalidMask & (1 << i)) != 0 || !_pidTable.isPIDOpened(pid)) {
 			if (filter && !_pidTable.isAllPID()) {
 				buffer.markTSForPurging(i);
 			}
@@ -152,12 +297,21 @@ void Filter::filterData(const FeID id, mpegts::PacketBuffer &buffer, const bool
 		_pidTable.addPIDData(pid, ptr[3]);
 		switch (pid) {
 			case 0:
+				if (_pat->isCollected() && _pat->isChangedSection(TableData::PAT_ID, ptr)) {
+					SI_LOG_INFO("Frontend: @#1, PAT - Version or CRC changed, collecting it again", id);
+					_pat = std::make_shared<PAT>();
+				}
 				if (!_pat->isCollected()) {
 					// collect PAT data
 					_pat->collectData(id, TableData::PAT_ID, ptr, false);
 					// Did we finish collecting PAT
 					if (_pat->isCollected()) {
 						_pat->parse(id);
+						// Remove the PMTs that are not in this PAT anymore
+						for (auto it = _pmtMap.begin(); it != _pmtMap.end(); ) {
+							it = _pat->isMarkedAsPMT(it->first) ? std::next(it) : _pmtMap.erase(it);
+						}
+						collected = true;
 					}
 				}
 				break;
@@ -165,6 +319,10 @@ void Filter::filterData(const FeID id, mpegts::PacketBuffer &buffer, const bool
 				// Empty
 				break;
 			case 16:
+				if (_nit->isCollected() && _nit->isChangedSection(TableData::NIT_ID, ptr)) {
+					SI_LOG_INFO("Frontend: @#1, NIT - Version or CRC changed, collecting it again", id);
+					_nit = std::make_shared<NIT>();
+				}
 				if (!_nit->isCollected()) {
 					// collect NIT data
 					_nit->collectData(id, TableData::NIT_ID, ptr, false);
@@ -172,16 +330,22 @@ void Filter::filterData(const FeID id, mpegts::PacketBuffer &buffer, const bool
 					// Did we finish collecting SDT
 					if (_nit->isCollected()) {
 						_nit->parse(id);
+						collected = true;
 					}
 				}
 				break;
 			case 17:
+				if (_sdt->isCollected() && _sdt->isChangedSection(TableData::SDT_ID, ptr)) {
+					SI_LOG_INFO("Frontend: @#1, SDT - Version or CRC changed, collecting it again", id);
+					_sdt = std::make_shared<SDT>();
+				}
 				if (!_sdt->isCollected()) {
 					// collect SDT data
 					_sdt->collectData(id, TableData::SDT_ID, ptr, false);
 					// Did we finish collecting SDT
 					if (_sdt->isCollected()) {
 						_sdt->parse(id);
+						collected = true;
 					}
 				}
 				break;
@@ -219,12 +383,22 @@ void Filter::filterData(const FeID id, mpegts::PacketBuffer &buffer, const bool
 			default:
 				if (_pat->isMarkedAsPMT(pid)) {
 					// Did we finish collecting PMT, we always get a valid PMT (empty or filled)
-					mpegts::SpPMT pmt = _pmtMap.try_emplace(pid, std::make_shared<PMT>()).first->second;
+					auto it = _pmtMap.find(pid);
+					if (it == _pmtMap.end()) {
+						it = _pmtMap.emplace(pid, std::make_shared<PMT>()).first;
+					}
+					mpegts::SpPMT &pmt = it->second;
+					if (pmt->isCollected() && pmt->isChangedSection(TableData::PMT_ID, ptr)) {
+						// Published PMTs are not changed, so collect it in a new one
+						SI_LOG_INFO("Frontend: @#1, PMT - PID @#2 - Version or CRC changed, collecting it again", id, PID(pid));
+						pmt = std::make_shared<PMT>();
+					}
 					if (!pmt->isCollected()) {
 						// collect PMT data
 						pmt->collectData(id, TableData::PMT_ID, ptr, false);
 						if (pmt->isCollected()) {
 							pmt->parse(id);
+							collected = true;
 						}
 #ifdef ADDDVBCA
 						const char fileFIFO[] = "/tmp/fifo";
@@ -235,7 +409,7 @@ void Filter::filterData(const FeID id, mpegts::PacketBuffer &buffer, const bool
 						}
 #endif
 					}
-				} else if (_filterPCR && PCR::isPCRTableData(ptr)) {
+				} else if (_filterPCR.load(std::memory_order_relaxed) && PCR::isPCRTableData(ptr)) {
 					for (const auto& [_, pmt] : _pmtMap) {
 						const int pcrPID = pmt->getPCRPid();
 						if (pid == pcrPID && _pidTable.isPIDOpened(pcrPID) && _pidTable.getPacketCounter(pcrPID) > 0) {
@@ -249,6 +423,7 @@ void Filter::filterData(const FeID id, mpegts::PacketBuffer &buffer, const bool
 	if (filter) {
 		buffer.purge();
 	}
+	return collected;
 }
 
 }
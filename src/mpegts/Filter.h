@@ -32,13 +32,24 @@
 #include <mpegts/PMT.h>
 #include <mpegts/SDT.h>
 
+#include <atomic>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 FW_DECL_NS1(mpegts, PacketBuffer);
 
 namespace mpegts {
 
-/// The class @c Filter carries the PID Tables
+/// The class @c Filter carries the PID Tables.
+/// The packet path (@see filterData) is owned by the one thread reading the
+/// device and runs without locks. The collected PAT/PMT/SDT/NIT tables are
+/// published to the other threads as an immutable snapshot. Changes from the
+/// other threads that touch the tables of the packet path are queued and
+/// handled by the packet path itself.
+/// A collected table with a new version or CRC is collected again in a new
+/// table, which is published when complete. So users, like the dvbapi client
+/// that sends each PMT once, see the changed table as a new one.
 class Filter :
 	public base::XMLSupport {
 		// =========================================================================
@@ -75,6 +86,19 @@ class Filter :
 		/// @param add specifies if true to open all the PIDs or false to close
 		void parsePIDString(FeID id, const std::string &reqPids, bool add);
 
+		/// Parse the CSV PID string with requested PIDs, like the other
+		/// @see parsePIDString, but update the PID set instead of @see PidTable
+		/// @param id
+		/// @param reqPids specifies the requested PIDs
+		/// @param add specifies if true to add the PIDs or false to remove
+		/// @param pids specifies the PID set to update
+		void parsePIDString(FeID id, const std::string &reqPids, bool add,
+			PidTable::PidSet &pids) const;
+
+		/// Use exactly the PIDs of the PID set, all other PIDs will be closed
+		/// with the next update of the PID filters
+		void setPIDs(const PidTable::PidSet &pids);
+
 		/// Add the filter data to MPEG Tables and
 		/// optionally purge TS packets from unused pids if filter is true
 		/// @param feID specifies the frontend ID
@@ -82,15 +106,22 @@ class Filter :
 		/// @param filter enables the software pid filtering
 		void filterData(FeID id, mpegts::PacketBuffer &buffer, bool filter);
 
+		/// Add the filter data of a batch of buffers to MPEG Tables
+		/// @param feID specifies the frontend ID
+		/// @param buffers specifies the first mpegts buffer of the batch
+		/// @param count specifies the amount of buffers in this batch
+		/// @param filter enables the software pid filtering
+		void filterData(FeID id, mpegts::PacketBuffer *buffers, std::size_t count, bool filter);
+
 		/// This will return true if the requested pid is the active/current one
-		/// accoording to the PCR that is open.
+		/// accoording to the PCR that is open. It uses the snapshot of the packet
+		/// path, so only use it from the thread that is calling @see filterData
 		/// @param pid specifies the PID to check if it is the current one
 		bool isMarkedAsActivePMT(int pid) const {
-			base::MutexLock lock(_mutex);
-			if (_pat->isMarkedAsPMT(pid) && _pmtMap.find(pid) != _pmtMap.end()) {
-				const int pcrPID = _pmtMap[pid]->getPCRPid();
-				if (_pidTable.isPIDOpened(pcrPID) && _pidTable.getPacketCounter(pcrPID) > 0) {
-					return true;
+			if (_packetSnapshot->pat->isMarkedAsPMT(pid)) {
+				const auto s = _packetSnapshot->pmtMap.find(pid);
+				if (s != _packetSnapshot->pmtMap.end()) {
+					return isPCRActive(s->second->getPCRPid());
 				}
 			}
 			return false;
@@ -101,44 +132,41 @@ class Filter :
 		/// return an empty PMT. When set to 0 it will try to return the current PMT
 		/// accoording the PCR that is open
 		mpegts::SpPMT getPMTData(int pid) const {
-			base::MutexLock lock(_mutex);
+			const SpSnapshot snapshot = getSnapshot();
 			if (pid == 0) {
 				// Try to find current PMT based on open PCR
-				for (const auto& [_, pmt] : _pmtMap) {
-					const int pcrPID = pmt->getPCRPid();
-					if (_pidTable.isPIDOpened(pcrPID) && _pidTable.getPacketCounter(pcrPID) > 0) {
+				for (const auto& [_, pmt] : snapshot->pmtMap) {
+					if (isPCRActive(pmt->getPCRPid())) {
 						return pmt;
 					}
 				}
 			}
-			if (_pmtMap.find(pid) != _pmtMap.end()) {
-				return _pmtMap[pid];
+			const auto s = snapshot->pmtMap.find(pid);
+			if (s != snapshot->pmtMap.end()) {
+				return s->second;
 			}
 			return std::make_shared<PMT>();
 		}
 
-		///
+		/// Get the PCR of the packet path, so only use it from the thread that
+		/// is calling @see filterData
 		mpegts::SpPCR getPCRData() const {
-			base::MutexLock lock(_mutex);
 			return _pcr;
 		}
 
 		///
 		mpegts::SpPAT getPATData() const {
-			base::MutexLock lock(_mutex);
-			return _pat;
+			return getSnapshot()->pat;
 		}
 
 		///
 		mpegts::SpSDT getSDTData() const {
-			base::MutexLock lock(_mutex);
-			return _sdt;
+			return getSnapshot()->sdt;
 		}
 
 		///
 		mpegts::SpNIT getNITData() const {
-			base::MutexLock lock(_mutex);
-			return _nit;
+			return getSnapshot()->nit;
 		}
 
 		// =========================================================================
@@ -146,13 +174,11 @@ class Filter :
 
 		/// Get the total amount of Continuity Counter Error
 		uint32_t getTotalCCErrors() const {
-			base::MutexLock lock(_mutex);
 			return _pidTable.getTotalCCErrors();
 		}
 
 		/// Get the CSV of all the requested PID
 		std::string getPidCSV() const {
-			base::MutexLock lock(_mutex);
 			return _pidTable.getPidCSV();
 		}
 
@@ -202,6 +228,10 @@ class Filter :
 
 	private:
 
+		/// @see filterData, the packet path for one buffer
+		/// @return true if a table was collected and should be published
+		bool filterPackets(FeID id, mpegts::PacketBuffer &buffer, bool filter);
+
 		/// Open requesed PID filter
 		/// @param feID specifies the frontend ID
 		/// @param pid specifies the PID to open with openPid
@@ -215,7 +245,7 @@ class Filter :
 				_pidTable.setPIDOpened(pid);
 				SI_LOG_DEBUG("Frontend: @#1, Set filter PID: @#2@#3",
 					feID, PID(pid),
-					_pat->isMarkedAsPMT(pid) ? " - PMT" : "");
+					getSnapshot()->pat->isMarkedAsPMT(pid) ? " - PMT" : "");
 			}
 		}
 
@@ -233,49 +263,83 @@ class Filter :
 					feID, PID(pid),
 					DIGIT(_pidTable.getPacketCounter(pid), 9),
 					DIGIT(_pidTable.getCCErrors(pid), 6),
-					_pat->isMarkedAsPMT(pid) ? " - PMT" : "");
+					getSnapshot()->pat->isMarkedAsPMT(pid) ? " - PMT" : "");
 				// Clear stats
 				_pidTable.setPIDClosed(pid);
-				// Need to clear the PID Tables as well?
-				if (pid == 0) {
-					_pat = std::make_shared<PAT>();
-				} else if (pid == 17) {
-					_sdt = std::make_shared<SDT>();
-				} else if (_pmtMap.find(pid) != _pmtMap.end()) {
-					_pmtMap.erase(pid);
-				} else {
-					// Did we close the PCR Pid
-					for (const auto& [_, pmt] : _pmtMap) {
-						const int pcrPID = pmt->getPCRPid();
-						if (pcrPID > 0 && pcrPID == pid) {
-							const int pmtPID = pmt->getAssociatedPID();
-							SI_LOG_DEBUG("Frontend: @#1, Remove filter PID: @#2 - PCR Changed for PMT: @#3 - Clearing tables", feID, PID(pid), PID(pmtPID));
-							_pcr = std::make_shared<PCR>();
-							break;
-						}
-					}
-				}
+				// Need to clear the PID Tables as well? Let the packet path do that
+				postCommand(feID, pid);
 			}
 		}
 
+		/// Check if the PCR pid is opened and receiving packets
+		bool isPCRActive(const int pcrPID) const {
+			return _pidTable.isPIDOpened(pcrPID) && _pidTable.getPacketCounter(pcrPID) > 0;
+		}
+
+		/// Queue a command for the packet path and remove the tables it will
+		/// clear from the published snapshot
+		/// @param feID specifies the frontend ID
+		/// @param pid specifies the closed PID or CLEAR_ALL to clear all tables
+		void postCommand(FeID feID, int pid);
+
+		/// Handle the queued commands, called by the packet path
+		void handleCommands();
+
+		/// Publish the collected tables of the packet path as new snapshot.
+		/// Skipped while there are commands queued, they will publish it again.
+		void publishSnapshot();
+
+		///
+		struct Snapshot {
+			mpegts::SpPAT pat;
+			mpegts::SpSDT sdt;
+			mpegts::SpNIT nit;
+			std::unordered_map<int, mpegts::SpPMT> pmtMap;
+		};
+		using SpSnapshot = std::shared_ptr<const Snapshot>;
+
+		/// Get the latest published snapshot
+		SpSnapshot getSnapshot() const {
+			return std::atomic_load(&_snapshot);
+		}
+
+		///
+		struct Command {
+			FeID feID;
+			int pid;
+		};
+
 		// =========================================================================
 		//  -- Data members --------------------------------------------------------
 		// =========================================================================
 	private:
 
+		static constexpr int CLEAR_ALL = -1;
+
+		// Guards the PID state, this lock is never taken by the packet path
 		mutable base::Mutex _mutex;
 
 		using PMTMap = std::unordered_map<int, mpegts::SpPMT>;
 
-		mutable PMTMap _pmtMap;
+		// Owned by the packet path
+		PMTMap _pmtMap;
+		mpegts::SpNIT _nit;
+		mpegts::SpPAT _pat;
+		mpegts::SpPCR _pcr;
+		mpegts::SpSDT _sdt;
 
-		mutable mpegts::PidTable _pidTable;
-		mutable mpegts::SpNIT _nit;
-		mutable mpegts::SpPAT _pat;
-		mutable mpegts::SpPCR _pcr;
-		mutable mpegts::SpSDT _sdt;
-		bool _filterPCR = false;
+		mpegts::PidTable _pidTable;
+		std::atomic_bool _filterPCR{false};
 		std::string _userPids;
+
+		std::mutex _commandMutex;
+		std::vector<Command> _commands;
+		std::atomic_bool _commandPending{false};
+
+		std::mutex _snapshotMutex;
+		SpSnapshot _snapshot;
+		// Owned by the packet path, refreshed for each (batch of) buffer(s)
+		SpSnapshot _packetSnapshot;
 };
 
 }
@@ -58,18 +58,18 @@ bool PacketBuffer::trySyncing() noexcept {
 	if (isSynced()) {
 		return true;
 	}
-	for (size_t i = RTP_HEADER_LEN; i < MTU_MAX_TS_PACKET_SIZE + RTP_HEADER_LEN - (TS_PACKET_SIZE * 2); ++i) {
-		const unsigned char* cData = _buffer + i;
-		if (cData[TS_PACKET_SIZE * 0] == 0x47 &&
-			cData[TS_PACKET_SIZE * 1] == 0x47 &&
-			cData[TS_PACKET_SIZE * 2] == 0x47) {
-			// found sync, now move it to begin of buffer
-			const size_t cpySize = (MTU_MAX_TS_PACKET_SIZE + RTP_HEADER_LEN) - i;
-			_writeIndex = _writeIndex - (i - RTP_HEADER_LEN);
-			_processedIndex = _writeIndex;
-			std::memmove(_buffer + RTP_HEADER_LEN, cData, cpySize);
-			return true;
-		}
+	const std::size_t i = PacketKernel::findSync(_tsData, MTU_MAX_TS_PACKET_SIZE);
+	if (i < MTU_MAX_TS_PACKET_SIZE) {
+		// found sync, now move it to begin of buffer
+		const unsigned char* cData = _tsData + i;
+		const size_t cpySize = MTU_MAX_TS_PACKET_SIZE - i;
+		_writeIndex = _writeIndex - i;
+		_processedIndex = _writeIndex;
+		std::memmove(_buffer + RTP_HEADER_LEN, cData, cpySize);
+		_tsData = _buffer + RTP_HEADER_LEN;
+		_externalRef.reset();
+		invalidatePacketSummary();
+		return true;
 	}
 	// did not find a sync, so flush buffer
 	reset();
@@ -82,6 +82,7 @@ void PacketBuffer::markTSForPurging(std::size_t packetNumber) noexcept {
 		unsigned char *cData = getTSPacketPtr(packetNumber);
 		cData[1] = 0xFF;
 		++_purgePending;
+		invalidatePacketSummary();
 	}
 }
 
@@ -100,9 +101,9 @@ void PacketBuffer::purge() noexcept {
 	}
 	const unsigned char* tsBegin = getTSReadBufferPtr();
 	const unsigned char* tsCheckBegin = getTSReadBufferPtr() + TS_PACKET_SIZE;
-	unsigned char* cDataPtr = _buffer + _writeIndex - TS_PACKET_SIZE;;
+	unsigned char* cDataPtr = getWriteBufferPtr() - TS_PACKET_SIZE;
 	const unsigned char* nextData = cDataPtr;
-	const unsigned char* endData = _buffer + _writeIndex;
+	const unsigned char* endData = getWriteBufferPtr();
 	// Purge trailing packets by moving pointer
 	for (; cDataPtr > tsBegin; cDataPtr -= TS_PACKET_SIZE) {
 		if (*(cDataPtr + 1) == 0xFF) {
@@ -127,27 +128,36 @@ void PacketBuffer::purge() noexcept {
 		}
 		nextData = cDataPtr;
 	}
-	_writeIndex = endData - _buffer;
+	_writeIndex = (endData - _tsData) + RTP_HEADER_LEN;
 	_processedIndex = _writeIndex;
+	invalidatePacketSummary();
 }
 
 void PacketBuffer::tagRTPHeaderWith(
 		const uint32_t ssrc, const uint16_t cseq, const long timestamp) noexcept {
+	makeRTPHeader(_buffer, ssrc, cseq, timestamp);
+}
+
+void PacketBuffer::makeRTPHeader(unsigned char *header,
+		const uint32_t ssrc, const uint16_t cseq, const long timestamp) noexcept {
+	header[0] = 0x80;                     // version: 2, padding: 0, extension: 0, CSRC: 0
+	header[1] = 33;                       // marker: 0, payload type: 33 (MP2T)
+
 	// update sequence number
-	_buffer[2] = ((cseq >> 8) & 0xFF);
-	_buffer[3] =  (cseq & 0xFF);
+	header[2] = ((cseq >> 8) & 0xFF);
+	header[3] =  (cseq & 0xFF);
 
 	// update timestamp
-	_buffer[4] = (timestamp >> 24) & 0xFF;
-	_buffer[5] = (timestamp >> 16) & 0xFF;
-	_buffer[6] = (timestamp >>  8) & 0xFF;
-	_buffer[7] = (timestamp >>  0) & 0xFF;
+	header[4] = (timestamp >> 24) & 0xFF;
+	header[5] = (timestamp >> 16) & 0xFF;
+	header[6] = (timestamp >>  8) & 0xFF;
+	header[7] = (timestamp >>  0) & 0xFF;
 
 	// Update synchronization source
-	_buffer[8]  = (ssrc >> 24) & 0xFF;
-	_buffer[9]  = (ssrc >> 16) & 0xFF;
-	_buffer[10] = (ssrc >>  8) & 0xFF;
-	_buffer[11] = (ssrc >>  0) & 0xFF;
+	header[8]  = (ssrc >> 24) & 0xFF;
+	header[9]  = (ssrc >> 16) & 0xFF;
+	header[10] = (ssrc >>  8) & 0xFF;
+	header[11] = (ssrc >>  0) & 0xFF;
 }
 
 }
@@ -20,8 +20,12 @@
 #ifndef MPEGTS_PACKET_BUFFER_H_INCLUDE
 #define MPEGTS_PACKET_BUFFER_H_INCLUDE MPEGTS_PACKET_BUFFER_H_INCLUDE
 
+#include <mpegts/PacketKernel.h>
+
+#include <atomic>
 #include <cstdint>
 #include <cstddef>
+#include <memory>
 
 namespace mpegts {
 
@@ -34,6 +38,10 @@ class PacketBuffer {
 
 		virtual ~PacketBuffer() = default;
 
+		PacketBuffer(const PacketBuffer&) = delete;
+
+		PacketBuffer& operator=(const PacketBuffer&) = delete;
+
 		// =====================================================================
 		// -- Other functions --------------------------------------------------
 		// =====================================================================
@@ -57,12 +65,33 @@ class PacketBuffer {
 			return RTP_HEADER_LEN == _writeIndex;
 		}
 
-		/// Reset this TS buffer
+		/// Reset this TS buffer, this will also release any attached external data
 		void reset() noexcept {
 			_decryptPending = false;
 			_purgePending = 0;
 			_writeIndex = RTP_HEADER_LEN;
 			_processedIndex = RTP_HEADER_LEN;
+			_tsData = _buffer + RTP_HEADER_LEN;
+			_externalRef.reset();
+			invalidatePacketSummary();
+		}
+
+		/// Attach external TS data to this empty TS buffer, instead of copying it
+		/// into the internal buffer. The data should be MTU_MAX_TS_PACKET_SIZE in
+		/// size and stay valid until this buffer is reset or attached again.
+		/// @param data specifies the begin of the first TS packet
+		/// @param ref specifies the reference that keeps @p data valid
+		void attachExternalData(unsigned char* data, std::shared_ptr<void> ref) noexcept {
+			_tsData = data;
+			_externalRef = std::move(ref);
+			_writeIndex = MTU_MAX_TS_PACKET_SIZE + RTP_HEADER_LEN;
+			_processedIndex = RTP_HEADER_LEN;
+			invalidatePacketSummary();
+		}
+
+		/// Check if the TS packets of this buffer are in external data
+		bool hasExternalData() const noexcept {
+			return _externalRef != nullptr;
 		}
 
 		/// try to sync this buffer
@@ -78,6 +107,40 @@ class PacketBuffer {
 		/// This will tag the RTP header with sequence number and timestamp
 		void tagRTPHeaderWith(uint32_t ssrc, uint16_t cseq, long timestamp) noexcept;
 
+		/// Make a complete RTP header (RTP_HEADER_LEN) with sequence number and timestamp
+		static void makeRTPHeader(unsigned char *header, uint32_t ssrc,
+			uint16_t cseq, long timestamp) noexcept;
+
+		/// Add a reference, this buffer is in a send queue and should not be reused
+		void addQueuedReference() noexcept {
+			++_queuedCnt;
+		}
+
+		/// Release a reference, this buffer was send or dropped by a send queue
+		void releaseQueuedReference() noexcept {
+			--_queuedCnt;
+		}
+
+		/// Check if this buffer is still in some send queue
+		bool isQueued() const noexcept {
+			return _queuedCnt != 0;
+		}
+
+		/// Add a reference, TS packets of this buffer are in a decrypt job
+		void addDecryptReference() noexcept {
+			_decryptCnt.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		/// Release a reference, the decrypt job with TS packets of this buffer is done
+		void releaseDecryptReference() noexcept {
+			_decryptCnt.fetch_sub(1, std::memory_order_release);
+		}
+
+		/// Check if TS packets of this buffer are still in some decrypt job
+		bool isDecrypting() const noexcept {
+			return _decryptCnt.load(std::memory_order_acquire) != 0;
+		}
+
 		/// This function will return the maximum number of TS Packets that will fit
 		/// in this TS buffer
 		static constexpr std::size_t getMaxNumberOfTSPackets() noexcept {
@@ -121,29 +184,45 @@ class PacketBuffer {
 
 		/// Get the write pointer for this TS buffer
 		unsigned char* getWriteBufferPtr() noexcept {
-			return &_buffer[_writeIndex];
+			return _tsData + (_writeIndex - RTP_HEADER_LEN);
 		}
 
-		/// This function will return the begin of this RTP packet
-		unsigned char *getReadBufferPtr() noexcept {
+		/// This function will return the RTP header of this RTP packet. The TS
+		/// packets are NOT guaranteed to follow this header in memory, so use
+		/// @see getTSReadBufferPtr for those
+		unsigned char *getRTPHeaderPtr() noexcept {
 			return _buffer;
 		}
 
 		/// This function will return the begin of the first TS packet in this TS buffer
 		/// so without RTP header
 		unsigned char* getTSReadBufferPtr() noexcept {
-			return &_buffer[RTP_HEADER_LEN];
+			return _tsData;
 		}
 
 		/// Get the TS packet pointer for packets 0 up until NUMBER_OF_TS_PACKETS
 		/// @param packetNumber a value from 0 up until NUMBER_OF_TS_PACKETS
 		unsigned char* getTSPacketPtr(std::size_t packetNumber) noexcept {
-			const std::size_t index = (packetNumber * TS_PACKET_SIZE) + RTP_HEADER_LEN;
-			return &_buffer[index];
+			return _tsData + (packetNumber * TS_PACKET_SIZE);
 		}
 		const unsigned char* getTSPacketPtr(std::size_t packetNumber) const noexcept {
-			const std::size_t index = (packetNumber * TS_PACKET_SIZE) + RTP_HEADER_LEN;
-			return &_buffer[index];
+			return _tsData + (packetNumber * TS_PACKET_SIZE);
+		}
+
+		/// Get the summary of the headers of the completed TS packets in this
+		/// buffer. It is made once, when the amount of packets changed or when
+		/// it was invalidated.
+		const PacketSummary &getPacketSummary() const noexcept {
+			const std::size_t packets = getNumberOfCompletedPackets();
+			if (_summary.packets != packets) {
+				PacketKernel::summarize(_tsData, packets, _summary);
+			}
+			return _summary;
+		}
+
+		/// Invalidate the summary, call this when the TS packet headers are changed
+		void invalidatePacketSummary() noexcept {
+			_summary.packets = PacketSummary::INVALID;
 		}
 
 		/// Set the decrypt pending flag, so we should check scramble flag if this
@@ -154,18 +233,24 @@ class PacketBuffer {
 
 		/// This function checks if this TS buffer is ready to be send.
 		/// There should be something in the buffer, in TS_PACKET_SIZE chunks.
-		/// When the pending decrypt flag was set, all scramble flags should
-		/// be cleared from all TS packets.
+		/// When the pending decrypt flag was set, all decrypt jobs should be
+		/// done and all scramble flags should be cleared from all TS packets.
 		bool isReadyToSend() const noexcept {
 			// ready to send, when there is something in the buffer in TS_PACKET_SIZE chunks
 			// and if all scramble flags are cleared
 //			bool ready = (getCurrentBufferSize() % TS_PACKET_SIZE) == 0;
 			bool ready = full();
+			if (_decryptPending && ready && isDecrypting()) {
+				return false;
+			}
 			if (_decryptPending && ready) {
-				const std::size_t size = getNumberOfCompletedPackets();
-				for (std::size_t i = 0; i < size; ++i) {
-					const unsigned char* ts = getTSPacketPtr(i);
-					ready &= ((ts[3] & 0x80) != 0x80);
+				// Only the packets that were scrambled, when this buffer was
+				// received, can still have the scramble flag set
+				unsigned int mask = getPacketSummary().scrambledMask;
+				while (ready && mask != 0) {
+					const unsigned char* ts = getTSPacketPtr(__builtin_ctz(mask));
+					ready = ((ts[3] & 0x80) != 0x80);
+					mask &= mask - 1;
 				}
 			}
 			return ready;
@@ -176,9 +261,9 @@ class PacketBuffer {
 		/// Check if the first three TS packets are in sync
 		bool isSynced() const noexcept {
 			return
-				_buffer[RTP_HEADER_LEN + (TS_PACKET_SIZE * 0)] == 0x47 &&
-				_buffer[RTP_HEADER_LEN + (TS_PACKET_SIZE * 1)] == 0x47 &&
-				_buffer[RTP_HEADER_LEN + (TS_PACKET_SIZE * 2)] == 0x47;
+				_tsData[TS_PACKET_SIZE * 0] == 0x47 &&
+				_tsData[TS_PACKET_SIZE * 1] == 0x47 &&
+				_tsData[TS_PACKET_SIZE * 2] == 0x47;
 		}
 
 		// =====================================================================
@@ -190,15 +275,21 @@ class PacketBuffer {
 		static constexpr size_t RTP_HEADER_LEN         =   12;
 		static constexpr size_t TS_PACKET_SIZE         =  188;
 		static constexpr size_t NUMBER_OF_TS_PACKETS   =    7;
+		static_assert(NUMBER_OF_TS_PACKETS <= PacketSummary::MAX_PACKETS, "PacketSummary too small");
 		static constexpr size_t MTU_MAX_TS_PACKET_SIZE = TS_PACKET_SIZE * NUMBER_OF_TS_PACKETS;
 
 	protected:
 
 		unsigned char       _buffer[MTU];
+		unsigned char*      _tsData = _buffer + RTP_HEADER_LEN;
+		std::shared_ptr<void> _externalRef;
 		std::size_t         _writeIndex = RTP_HEADER_LEN;
 		mutable std::size_t _processedIndex = RTP_HEADER_LEN;
 		bool                _decryptPending = false;
 		std::size_t         _purgePending = 0;
+		std::atomic<unsigned int> _queuedCnt{0};
+		std::atomic<unsigned int> _decryptCnt{0};
+		mutable PacketSummary _summary;
 
 };
 
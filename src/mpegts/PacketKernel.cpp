@@ -0,0 +1,319 @@
+/* PacketKernel.cpp
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <mpegts/PacketKernel.h>
+
+#include <cstring>
+
+#if defined(__SSE2__)
+	#include <emmintrin.h>
+	#define PACKET_KERNEL_SSE2
+	#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+		#include <immintrin.h>
+		#define PACKET_KERNEL_AVX2
+	#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define PACKET_KERNEL_NEON
+#endif
+
+namespace mpegts {
+
+static_assert(PacketSummary::MAX_PACKETS == 8, "Masks of PacketSummary should fit 8 packets");
+
+// =============================================================================
+//  -- Scalar functions --------------------------------------------------------
+// =============================================================================
+
+static std::size_t findSyncScalar(const unsigned char *data, std::size_t begin,
+		const std::size_t end, const std::size_t size) noexcept {
+	for (; begin < end; ++begin) {
+		if (data[begin] == 0x47 &&
+			data[begin + (PacketKernel::TS_PACKET_SIZE * 1)] == 0x47 &&
+			data[begin + (PacketKernel::TS_PACKET_SIZE * 2)] == 0x47) {
+			return begin;
+		}
+	}
+	return size;
+}
+
+#if !defined(PACKET_KERNEL_SSE2) && !defined(PACKET_KERNEL_NEON)
+static void summarizeScalar(const unsigned char *data, const std::size_t packets,
+		PacketSummary &summary) noexcept {
+	summary.syncMask = 0;
+	summary.teiMask = 0;
+	summary.nullMask = 0;
+	summary.scrambledMask = 0;
+	summary.oddMask = 0;
+	for (std::size_t i = 0; i < packets; ++i) {
+		const unsigned char *ts = data + (i * PacketKernel::TS_PACKET_SIZE);
+		const uint8_t bit = 1 << i;
+		const uint16_t pid = ((ts[1] & 0x1F) << 8) | ts[2];
+		summary.pid[i] = pid;
+		summary.syncMask |= (ts[0] == 0x47) ? bit : 0;
+		summary.teiMask |= ((ts[1] & 0x80) == 0x80) ? bit : 0;
+		summary.nullMask |= (pid == 0x1FFF) ? bit : 0;
+		summary.scrambledMask |= ((ts[3] & 0x80) == 0x80) ? bit : 0;
+		summary.oddMask |= ((ts[3] & 0x40) == 0x40) ? bit : 0;
+	}
+}
+#else
+/// Collect the 4 header bytes of each TS packet, so they can be checked at
+/// once. The header of TS packet n is in @p header[n] as little endian.
+static void loadHeaders(const unsigned char *data, const std::size_t packets,
+		uint32_t (&header)[PacketSummary::MAX_PACKETS]) noexcept {
+	for (std::size_t i = 0; i < PacketSummary::MAX_PACKETS; ++i) {
+		header[i] = 0;
+		if (i < packets) {
+			const unsigned char *ts = data + (i * PacketKernel::TS_PACKET_SIZE);
+			header[i] = ts[0] | (ts[1] << 8) | (ts[2] << 16) | (static_cast<uint32_t>(ts[3]) << 24);
+		}
+	}
+}
+#endif
+
+#if defined(PACKET_KERNEL_SSE2)
+// =============================================================================
+//  -- SSE2 functions ----------------------------------------------------------
+// =============================================================================
+
+static std::size_t findSyncSSE2(const unsigned char *data, const std::size_t end,
+		const std::size_t size) noexcept {
+	const __m128i sync = _mm_set1_epi8(0x47);
+	std::size_t i = 0;
+	for (; i + 16 <= end; i += 16) {
+		const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+		const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + (PacketKernel::TS_PACKET_SIZE * 1)));
+		const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + (PacketKernel::TS_PACKET_SIZE * 2)));
+		const __m128i m = _mm_and_si128(_mm_cmpeq_epi8(a, sync),
+			_mm_and_si128(_mm_cmpeq_epi8(b, sync), _mm_cmpeq_epi8(c, sync)));
+		const unsigned int mask = _mm_movemask_epi8(m);
+		if (mask != 0) {
+			return i + __builtin_ctz(mask);
+		}
+	}
+	return findSyncScalar(data, i, end, size);
+}
+
+static inline unsigned int movemask32(const __m128i v) noexcept {
+	return _mm_movemask_ps(_mm_castsi128_ps(v));
+}
+
+static void summarizeSSE2(const unsigned char *data, const std::size_t packets,
+		PacketSummary &summary) noexcept {
+	uint32_t header[PacketSummary::MAX_PACKETS];
+	loadHeaders(data, packets, header);
+	const __m128i syncByte = _mm_set1_epi32(0x47);
+	const __m128i byteMask = _mm_set1_epi32(0xFF);
+	const __m128i pidHigh = _mm_set1_epi32(0x1F00);
+	const __m128i nullPid = _mm_set1_epi32(0x1FFF);
+	unsigned int mask[5] = { 0, 0, 0, 0, 0 };
+	__m128i pid[2];
+	for (std::size_t i = 0; i < 2; ++i) {
+		const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(header + (i * 4)));
+		pid[i] = _mm_or_si128(_mm_and_si128(h, pidHigh), _mm_and_si128(_mm_srli_epi32(h, 16), byteMask));
+		const unsigned int shift = i * 4;
+		mask[0] |= movemask32(_mm_cmpeq_epi32(_mm_and_si128(h, byteMask), syncByte)) << shift;
+		mask[1] |= movemask32(_mm_slli_epi32(h, 16)) << shift;
+		mask[2] |= movemask32(_mm_cmpeq_epi32(pid[i], nullPid)) << shift;
+		mask[3] |= movemask32(h) << shift;
+		mask[4] |= movemask32(_mm_slli_epi32(h, 1)) << shift;
+	}
+	// PIDs are 13 bits, so the signed saturation does not change them
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(summary.pid), _mm_packs_epi32(pid[0], pid[1]));
+	const unsigned int valid = (1u << packets) - 1;
+	summary.syncMask = mask[0] & valid;
+	summary.teiMask = mask[1] & valid;
+	summary.nullMask = mask[2] & valid;
+	summary.scrambledMask = mask[3] & valid;
+	summary.oddMask = mask[4] & valid;
+}
+#endif
+
+#if defined(PACKET_KERNEL_AVX2)
+// =============================================================================
+//  -- AVX2 functions ----------------------------------------------------------
+// =============================================================================
+
+__attribute__((target("avx2")))
+static std::size_t findSyncAVX2(const unsigned char *data, const std::size_t end,
+		const std::size_t size) noexcept {
+	const __m256i sync = _mm256_set1_epi8(0x47);
+	std::size_t i = 0;
+	for (; i + 32 <= end; i += 32) {
+		const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+		const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + (PacketKernel::TS_PACKET_SIZE * 1)));
+		const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + (PacketKernel::TS_PACKET_SIZE * 2)));
+		const __m256i m = _mm256_and_si256(_mm256_cmpeq_epi8(a, sync),
+			_mm256_and_si256(_mm256_cmpeq_epi8(b, sync), _mm256_cmpeq_epi8(c, sync)));
+		const unsigned int mask = _mm256_movemask_epi8(m);
+		if (mask != 0) {
+			return i + __builtin_ctz(mask);
+		}
+	}
+	return findSyncScalar(data, i, end, size);
+}
+
+__attribute__((target("avx2")))
+static void summarizeAVX2(const unsigned char *data, const std::size_t packets,
+		PacketSummary &summary) noexcept {
+	uint32_t header[PacketSummary::MAX_PACKETS];
+	loadHeaders(data, packets, header);
+	const __m256i byteMask = _mm256_set1_epi32(0xFF);
+	const __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(header));
+	const __m256i pid = _mm256_or_si256(_mm256_and_si256(h, _mm256_set1_epi32(0x1F00)),
+		_mm256_and_si256(_mm256_srli_epi32(h, 16), byteMask));
+	const auto movemask = [](const __m256i v) __attribute__((target("avx2"))) {
+		return static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(v)));
+	};
+	// PIDs are 13 bits, so the signed saturation does not change them
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(summary.pid),
+		_mm_packs_epi32(_mm256_castsi256_si128(pid), _mm256_extracti128_si256(pid, 1)));
+	const unsigned int valid = (1u << packets) - 1;
+	summary.syncMask = movemask(_mm256_cmpeq_epi32(_mm256_and_si256(h, byteMask), _mm256_set1_epi32(0x47))) & valid;
+	summary.teiMask = movemask(_mm256_slli_epi32(h, 16)) & valid;
+	summary.nullMask = movemask(_mm256_cmpeq_epi32(pid, _mm256_set1_epi32(0x1FFF))) & valid;
+	summary.scrambledMask = movemask(h) & valid;
+	summary.oddMask = movemask(_mm256_slli_epi32(h, 1)) & valid;
+}
+
+static bool hasAVX2() noexcept {
+	static const bool avx2 = __builtin_cpu_supports("avx2");
+	return avx2;
+}
+#endif
+
+#if defined(PACKET_KERNEL_NEON)
+// =============================================================================
+//  -- NEON functions ----------------------------------------------------------
+// =============================================================================
+
+static std::size_t findSyncNEON(const unsigned char *data, const std::size_t end,
+		const std::size_t size) noexcept {
+	const uint8x16_t sync = vdupq_n_u8(0x47);
+	std::size_t i = 0;
+	for (; i + 16 <= end; i += 16) {
+		const uint8x16_t a = vld1q_u8(data + i);
+		const uint8x16_t b = vld1q_u8(data + i + (PacketKernel::TS_PACKET_SIZE * 1));
+		const uint8x16_t c = vld1q_u8(data + i + (PacketKernel::TS_PACKET_SIZE * 2));
+		const uint8x16_t m = vandq_u8(vceqq_u8(a, sync), vandq_u8(vceqq_u8(b, sync), vceqq_u8(c, sync)));
+		// Narrow to 4 bits for each byte, to get a 64 bit mask
+		const uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+		if (mask != 0) {
+			return i + (__builtin_ctzll(mask) >> 2);
+		}
+	}
+	return findSyncScalar(data, i, end, size);
+}
+
+static inline unsigned int movemask32(const uint32x4_t v) noexcept {
+	static const uint32_t bits[4] = { 1, 2, 4, 8 };
+	const uint32x4_t m = vandq_u32(v, vld1q_u32(bits));
+	uint32x2_t sum = vadd_u32(vget_low_u32(m), vget_high_u32(m));
+	sum = vpadd_u32(sum, sum);
+	return vget_lane_u32(sum, 0);
+}
+
+static void summarizeNEON(const unsigned char *data, const std::size_t packets,
+		PacketSummary &summary) noexcept {
+	uint32_t header[PacketSummary::MAX_PACKETS];
+	loadHeaders(data, packets, header);
+	const uint32x4_t byteMask = vdupq_n_u32(0xFF);
+	unsigned int mask[5] = { 0, 0, 0, 0, 0 };
+	for (std::size_t i = 0; i < 2; ++i) {
+		const uint32x4_t h = vld1q_u32(header + (i * 4));
+		const uint32x4_t pid = vorrq_u32(vandq_u32(h, vdupq_n_u32(0x1F00)),
+			vandq_u32(vshrq_n_u32(h, 16), byteMask));
+		vst1_u16(summary.pid + (i * 4), vmovn_u32(pid));
+		const unsigned int shift = i * 4;
+		mask[0] |= movemask32(vceqq_u32(vandq_u32(h, byteMask), vdupq_n_u32(0x47))) << shift;
+		mask[1] |= movemask32(vtstq_u32(h, vdupq_n_u32(0x8000))) << shift;
+		mask[2] |= movemask32(vceqq_u32(pid, vdupq_n_u32(0x1FFF))) << shift;
+		mask[3] |= movemask32(vtstq_u32(h, vdupq_n_u32(0x80000000))) << shift;
+		mask[4] |= movemask32(vtstq_u32(h, vdupq_n_u32(0x40000000))) << shift;
+	}
+	const unsigned int valid = (1u << packets) - 1;
+	summary.syncMask = mask[0] & valid;
+	summary.teiMask = mask[1] & valid;
+	summary.nullMask = mask[2] & valid;
+	summary.scrambledMask = mask[3] & valid;
+	summary.oddMask = mask[4] & valid;
+}
+#endif
+
+// =============================================================================
+//  -- Static member functions -------------------------------------------------
+// =============================================================================
+
+std::size_t PacketKernel::findSync(const unsigned char *data, const std::size_t size) noexcept {
+	if (size <= (TS_PACKET_SIZE * 2)) {
+		return size;
+	}
+	const std::size_t end = size - (TS_PACKET_SIZE * 2);
+#if defined(PACKET_KERNEL_AVX2)
+	if (hasAVX2()) {
+		return findSyncAVX2(data, end, size);
+	}
+#endif
+#if defined(PACKET_KERNEL_SSE2)
+	return findSyncSSE2(data, end, size);
+#elif defined(PACKET_KERNEL_NEON)
+	return findSyncNEON(data, end, size);
+#else
+	return findSyncScalar(data, 0, end, size);
+#endif
+}
+
+void PacketKernel::summarize(const unsigned char *data, std::size_t packets,
+		PacketSummary &summary) noexcept {
+	if (packets > PacketSummary::MAX_PACKETS) {
+		packets = PacketSummary::MAX_PACKETS;
+	}
+	summary.packets = packets;
+#if defined(PACKET_KERNEL_AVX2)
+	if (hasAVX2()) {
+		summarizeAVX2(data, packets, summary);
+		return;
+	}
+#endif
+#if defined(PACKET_KERNEL_SSE2)
+	summarizeSSE2(data, packets, summary);
+#elif defined(PACKET_KERNEL_NEON)
+	summarizeNEON(data, packets, summary);
+#else
+	summarizeScalar(data, packets, summary);
+#endif
+}
+
+const char *PacketKernel::getImplementationName() noexcept {
+#if defined(PACKET_KERNEL_AVX2)
+	if (hasAVX2()) {
+		return "AVX2";
+	}
+#endif
+#if defined(PACKET_KERNEL_SSE2)
+	return "SSE2";
+#elif defined(PACKET_KERNEL_NEON)
+	return "NEON";
+#else
+	return "Scalar";
+#endif
+}
+
+}
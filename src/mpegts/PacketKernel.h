@@ -0,0 +1,71 @@
+/* PacketKernel.h
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef MPEGTS_PACKET_KERNEL_H_INCLUDE
+#define MPEGTS_PACKET_KERNEL_H_INCLUDE MPEGTS_PACKET_KERNEL_H_INCLUDE
+
+#include <cstdint>
+#include <cstddef>
+
+namespace mpegts {
+
+/// The struct @c PacketSummary carries the header information of the TS
+/// packets of one buffer, so they do not have to be parsed again and again.
+/// Bit n of the masks is for TS packet n.
+struct PacketSummary {
+	static constexpr std::size_t MAX_PACKETS = 8;
+	static constexpr uint8_t INVALID = 0xFF;
+
+	uint16_t pid[MAX_PACKETS];
+	uint8_t packets = INVALID;   /// the amount of TS packets in this summary
+	uint8_t syncMask;            /// starts with the SYNC Byte
+	uint8_t teiMask;             /// has the Transport Error Indicator set
+	uint8_t nullMask;            /// is a NULL packet
+	uint8_t scrambledMask;       /// is scrambled
+	uint8_t oddMask;             /// is scrambled with the odd key
+};
+
+/// The class @c PacketKernel has the (SIMD) functions to check a buffer with
+/// TS packets. It uses AVX2 or SSE2 on x86 and NEON on ARM when available,
+/// else the scalar versions.
+class PacketKernel {
+	public:
+
+		/// Find the first position where three SYNC Bytes are TS_PACKET_SIZE apart
+		/// @param data specifies the data to search in
+		/// @param size specifies the size of the data
+		/// @return the position or @p size when not found
+		static std::size_t findSync(const unsigned char *data, std::size_t size) noexcept;
+
+		/// Make the summary of the headers of the TS packets in @p data
+		/// @param data specifies the begin of the first TS packet
+		/// @param packets specifies the amount of TS packets, up to MAX_PACKETS
+		/// @param summary specifies the summary to fill
+		static void summarize(const unsigned char *data, std::size_t packets,
+			PacketSummary &summary) noexcept;
+
+		/// Get the name of the used implementation
+		static const char *getImplementationName() noexcept;
+
+		static constexpr std::size_t TS_PACKET_SIZE = 188;
+};
+
+}
+
+#endif // MPEGTS_PACKET_KERNEL_H_INCLUDE
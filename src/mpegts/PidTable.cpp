@@ -28,9 +28,18 @@ namespace mpegts {
 // =============================================================================
 // -- Constructors and destructor ----------------------------------------------
 // =============================================================================
-PidTable::PidTable() noexcept {
+PidTable::PidTable() noexcept :
+		_usedSlots(0) {
+	_allPIDs = false;
+	for (std::size_t i = 0; i < OPENED_WORDS; ++i) {
+		_opened[i] = 0;
+	}
 	for (size_t i = 0; i < MAX_PIDS; ++i) {
-		resetPidData(i);
+		_state[i] = State::Closed;
+	}
+	for (std::size_t i = 0; i < PAGES; ++i) {
+		_slotPages[i] = nullptr;
+		_statsPages[i] = nullptr;
 	}
 	_changed = false;
 	_totalCCErrors = 0;
@@ -38,6 +47,13 @@ PidTable::PidTable() noexcept {
 	_totalCCErrorsBeginSet = false;
 }
 
+PidTable::~PidTable() {
+	for (std::size_t i = 0; i < PAGES; ++i) {
+		delete[] _slotPages[i].load();
+		delete[] _statsPages[i].load();
+	}
+}
+
 // =============================================================================
 //  -- Other member functions --------------------------------------------------
 // =============================================================================
@@ -48,7 +64,7 @@ void PidTable::clear() noexcept {
 	for (size_t i = 0; i < MAX_PIDS; ++i) {
 		// Check PID still open.
 		// Then set PID not used, to handle and close them later
-		if (_data[i].state != State::Closed && _data[i].state != State::ShouldOpen) {
+		if (_state[i] != State::Closed && _state[i] != State::ShouldOpen) {
 			setPID(i, false);
 		} else {
 			resetPidData(i);
@@ -56,20 +72,38 @@ void PidTable::clear() noexcept {
 	}
 }
 
+void PidTable::setState(const int pid, const State state) noexcept {
+	_state[pid] = state;
+	const uint64_t bit = uint64_t(1) << (pid % 64);
+	if (state == State::Opened) {
+		_opened[pid / 64].fetch_or(bit, std::memory_order_release);
+	} else {
+		_opened[pid / 64].fetch_and(~bit, std::memory_order_release);
+	}
+	if (pid == ALL_PIDS) {
+		_allPIDs = (state == State::Opened);
+	}
+}
+
 void PidTable::resetPidData(const int pid) noexcept {
-	_data[pid].state    = State::Closed;
-	_data[pid].cc       = 0x80;
-	_data[pid].cc_error = 0;
-	_data[pid].count    = 0;
+	setState(pid, State::Closed);
+	std::atomic<uint16_t> *page = _slotPages[pid / PAGE_SIZE].load(std::memory_order_relaxed);
+	if (page == nullptr) {
+		return;
+	}
+	const uint16_t slot = page[pid % PAGE_SIZE].exchange(NO_SLOT, std::memory_order_acq_rel);
+	if (slot != NO_SLOT) {
+		_freeSlots.push_back(slot);
+	}
 }
 
 std::string PidTable::getPidCSV() const {
-	if (_data[ALL_PIDS].state == State::Opened) {
+	if (isAllPID()) {
 		return "all";
 	}
 	std::string csv;
 	for (size_t i = 0; i < MAX_PIDS; ++i) {
-		if (_data[i].state == State::Opened) {
+		if (isPIDOpened(i)) {
 			csv += StringConverter::stringFormat("@#1,", i);
 		}
 	}
@@ -81,22 +115,22 @@ std::string PidTable::getPidCSV() const {
 }
 
 void PidTable::setPID(const int pid, const bool use) noexcept {
-	switch (_data[pid].state) {
+	switch (_state[pid]) {
 		case State::Closed:
 			if (use) {
-				_data[pid].state = State::ShouldOpen;
+				setState(pid, State::ShouldOpen);
 				_changed = true;
 			}
 			break;
 		case State::ShouldClose:
 			if (use) {
-				_data[pid].state = State::ShouldCloseReopen;
+				setState(pid, State::ShouldCloseReopen);
 				_changed = true;
 			}
 			break;
 		case State::Opened:
 			if (!use) {
-				_data[pid].state = State::ShouldClose;
+				setState(pid, State::ShouldClose);
 				_changed = true;
 			}
 			break;
@@ -106,19 +140,45 @@ void PidTable::setPID(const int pid, const bool use) noexcept {
 	}
 }
 
+void PidTable::setPIDOpened(const int pid) noexcept {
+	std::atomic<uint16_t> *page = _slotPages[pid / PAGE_SIZE].load(std::memory_order_relaxed);
+	if (page == nullptr) {
+		page = new std::atomic<uint16_t>[PAGE_SIZE];
+		for (std::size_t i = 0; i < PAGE_SIZE; ++i) {
+			page[i].store(NO_SLOT, std::memory_order_relaxed);
+		}
+		_slotPages[pid / PAGE_SIZE].store(page, std::memory_order_release);
+	}
+	if (page[pid % PAGE_SIZE] == NO_SLOT) {
+		uint16_t slot = _usedSlots;
+		if (_freeSlots.empty()) {
+			++_usedSlots;
+		} else {
+			slot = _freeSlots.back();
+			_freeSlots.pop_back();
+		}
+		PidStats *stats = _statsPages[slot / PAGE_SIZE].load(std::memory_order_relaxed);
+		if (stats == nullptr) {
+			stats = new PidStats[PAGE_SIZE];
+			_statsPages[slot / PAGE_SIZE].store(stats, std::memory_order_release);
+		}
+		PidStats &data = stats[slot % PAGE_SIZE];
+		data.cc       = 0x80;
+		data.cc_error = 0;
+		data.count    = 0;
+		// Publish the slot last, the packet path may use it directly
+		page[pid % PAGE_SIZE].store(slot, std::memory_order_release);
+	}
+	setState(pid, State::Opened);
+}
+
 void PidTable::setPIDClosed(const int pid) noexcept {
-	switch (_data[pid].state) {
-		case State::ShouldCloseReopen:
-			_data[pid].state = State::ShouldOpen;
-			_changed = true;
-			break;
-		default:
-			_data[pid].state = State::Closed;
-			break;
+	const bool reopen = _state[pid] == State::ShouldCloseReopen;
+	resetPidData(pid);
+	if (reopen) {
+		setState(pid, State::ShouldOpen);
+		_changed = true;
 	}
-	_data[pid].cc       = 0x80;
-	_data[pid].cc_error = 0;
-	_data[pid].count    = 0;
 }
 
 }
@@ -20,12 +20,21 @@
 #ifndef MPEGTS_PIDTABLE_H_INCLUDE
 #define MPEGTS_PIDTABLE_H_INCLUDE MPEGTS_PIDTABLE_H_INCLUDE
 
+#include <atomic>
+#include <bitset>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 namespace mpegts {
 
-/// The class @c PidTable carries all the PID and DMX information
+/// The class @c PidTable carries all the PID and DMX information.
+/// The per packet lookup only uses a bitmap of the opened PIDs, the counters
+/// are kept in compact slots for the opened PIDs only. The slot of a PID and
+/// the counters are allocated in pages when they are first needed, and stay
+/// until the table is destroyed, so the packet path never sees them move.
+/// The packet path (addPIDData, isPIDOpened, isAllPID and the counters) may be
+/// used without lock, all other functions should be called under one lock.
 class PidTable {
 		// =========================================================================
 		//  -- Constructors and destructor -----------------------------------------
@@ -34,7 +43,11 @@ class PidTable {
 
 		PidTable() noexcept;
 
-		virtual ~PidTable() = default;
+		virtual ~PidTable();
+
+		PidTable(const PidTable&) = delete;
+
+		PidTable& operator=(const PidTable&) = delete;
 
 		// =========================================================================
 		//  -- Other member functions ----------------------------------------------
@@ -56,45 +69,55 @@ class PidTable {
 
 		/// Get the amount of packet that were received of this pid
 		uint32_t getPacketCounter(const int pid) const noexcept {
-			return _data[pid].count;
+			const uint16_t slot = getSlot(pid);
+			return (slot != NO_SLOT) ? getStats(slot).count.load(std::memory_order_relaxed) : 0;
 		}
 
 		/// Get the amount Continuity Counter Error of this pid
 		uint32_t getCCErrors(const int pid) const noexcept {
-			return _data[pid].cc_error;
+			const uint16_t slot = getSlot(pid);
+			return (slot != NO_SLOT) ? getStats(slot).cc_error.load(std::memory_order_relaxed) : 0;
 		}
 
 		/// Get the total amount of Continuity Counter Error
 		uint32_t getTotalCCErrors() const noexcept {
-			return _totalCCErrors - _totalCCErrorsBegin;
+			return _totalCCErrors.load(std::memory_order_relaxed) -
+				_totalCCErrorsBegin.load(std::memory_order_relaxed);
 		}
 
 		/// Get the CSV of all the requested PID
 		std::string getPidCSV() const;
 
-		/// Set the continuity counter for pid
+		/// Set the continuity counter for pid, the pid should be opened.
+		/// There is only one packet path, so the counters are not updated with
+		/// read-modify-write operations.
 		void addPIDData(const int pid, const uint8_t ccByte) noexcept {
-			PidData &data = _data[pid];
-			++data.count;
+			const uint16_t slot = getSlot(pid);
+			if (slot == NO_SLOT) {
+				// Just closed
+				return;
+			}
+			PidStats &data = getStats(slot);
+			data.count.store(data.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
 			// Only if it has a Payload
 			if ((ccByte & 0x10) == 0x10) {
 				const uint8_t cc = ccByte & 0x0F;
-				if (data.cc == 0x80) {
-					data.cc = cc;
-					if (!_totalCCErrorsBeginSet) {
-						_totalCCErrorsBegin = _totalCCErrors;
-						_totalCCErrorsBeginSet = true;
+				uint8_t dataCC = data.cc.load(std::memory_order_relaxed);
+				if (dataCC == 0x80) {
+					data.cc.store(cc, std::memory_order_relaxed);
+					if (!_totalCCErrorsBeginSet.load(std::memory_order_relaxed)) {
+						_totalCCErrorsBegin.store(_totalCCErrors.load(std::memory_order_relaxed), std::memory_order_relaxed);
+						_totalCCErrorsBeginSet.store(true, std::memory_order_relaxed);
 					}
 					return;
 				}
-				++data.cc;
-				data.cc %= 0x10;
-				if (data.cc != cc) {
-					const uint8_t diff = (cc >= data.cc) ? (cc - data.cc) : ((0x10 - data.cc) + cc);
-					data.cc = cc;
-					data.cc_error += diff;
-					_totalCCErrors += diff;
+				dataCC = (dataCC + 1) % 0x10;
+				if (dataCC != cc) {
+					const uint8_t diff = (cc >= dataCC) ? (cc - dataCC) : ((0x10 - dataCC) + cc);
+					data.cc_error.store(data.cc_error.load(std::memory_order_relaxed) + diff, std::memory_order_relaxed);
+					_totalCCErrors.store(_totalCCErrors.load(std::memory_order_relaxed) + diff, std::memory_order_relaxed);
 				}
+				data.cc.store(cc, std::memory_order_relaxed);
 			}
 		}
 
@@ -103,13 +126,13 @@ class PidTable {
 
 		/// Check if this pid is opened
 		bool isPIDOpened(const int pid) const noexcept {
-			return _data[pid].state == State::Opened;
+			return (_opened[pid / 64].load(std::memory_order_acquire) >> (pid % 64)) & 1;
 		}
 
 		/// Check if this pid should be closed
 		bool shouldPIDClose(const int pid) const noexcept {
-			return _data[pid].state == State::ShouldClose ||
-				_data[pid].state == State::ShouldCloseReopen;
+			return _state[pid] == State::ShouldClose ||
+				_state[pid] == State::ShouldCloseReopen;
 		}
 
 		/// Set that this pid is closed
@@ -117,13 +140,11 @@ class PidTable {
 
 		/// Check if PID should be opened
 		bool shouldPIDOpen(const int pid) const noexcept {
-			return _data[pid].state == State::ShouldOpen;
+			return _state[pid] == State::ShouldOpen;
 		}
 
 		/// Set that this pid is opened
-		void setPIDOpened(const int pid) noexcept {
-			_data[pid].state = State::Opened;
-		}
+		void setPIDOpened(int pid) noexcept;
 
 		/// Set all PID
 		void setAllPID(const bool use) noexcept {
@@ -132,14 +153,43 @@ class PidTable {
 
 		/// Check if all PIDs (full Transport Stream) is on
 		bool isAllPID() const noexcept {
-			return _data[ALL_PIDS].state == State::Opened;
+			return _allPIDs.load(std::memory_order_relaxed);
 		}
 
-	protected:
+	private:
+
+		enum class State : uint8_t {
+			ShouldOpen,
+			Opened,
+			ShouldClose,
+			ShouldCloseReopen,
+			Closed
+		};
+
+		/// Set the state of pid and keep the opened bitmap up to date
+		void setState(int pid, State state) noexcept;
 
-		/// Reset the pid data like counters etc.
+		/// Reset the pid data like counters etc. and release its slot
 		void resetPidData(int pid) noexcept;
 
+		// PID Statistics
+		struct PidStats {
+			std::atomic<uint8_t> cc;        /// continuity counter (0 - 15) of this PID
+			std::atomic<uint32_t> cc_error; /// cc error count
+			std::atomic<uint32_t> count;    /// the number of times this pid occurred
+		};
+
+		/// Get the slot of the counters of pid, or NO_SLOT when it has none
+		uint16_t getSlot(const int pid) const noexcept {
+			const std::atomic<uint16_t> *page = _slotPages[pid / PAGE_SIZE].load(std::memory_order_acquire);
+			return (page != nullptr) ? page[pid % PAGE_SIZE].load(std::memory_order_acquire) : NO_SLOT;
+		}
+
+		/// Get the counters of an allocated slot
+		PidStats &getStats(const uint16_t slot) const noexcept {
+			return _statsPages[slot / PAGE_SIZE].load(std::memory_order_acquire)[slot % PAGE_SIZE];
+		}
+
 		// =========================================================================
 		//  -- Data members --------------------------------------------------------
 		// =========================================================================
@@ -148,30 +198,32 @@ class PidTable {
 		static constexpr int MAX_PIDS = 8193;
 		static constexpr int ALL_PIDS = 8192;
 
+		/// A set of PIDs, where ALL_PIDS means the full Transport Stream
+		using PidSet = std::bitset<MAX_PIDS>;
+
 	protected:
 
 	private:
 
-		enum class State {
-			ShouldOpen,
-			Opened,
-			ShouldClose,
-			ShouldCloseReopen,
-			Closed
-		};
+		static constexpr uint16_t NO_SLOT = 0xFFFF;
+		static constexpr std::size_t OPENED_WORDS = (MAX_PIDS + 63) / 64;
+		/// The amount of PIDs (or slots) that are allocated at once
+		static constexpr std::size_t PAGE_SIZE = 64;
+		static constexpr std::size_t PAGES = (MAX_PIDS + PAGE_SIZE - 1) / PAGE_SIZE;
 
-		// PID State
-		struct PidData {
-			State state;
-			uint8_t cc;        /// continuity counter (0 - 15) of this PID
-			uint32_t cc_error; /// cc error count
-			uint32_t count;    /// the number of times this pid occurred
-		};
-		uint32_t _totalCCErrors;
-		uint32_t _totalCCErrorsBegin;
-		bool _totalCCErrorsBeginSet;
+		std::atomic<uint32_t> _totalCCErrors;
+		std::atomic<uint32_t> _totalCCErrorsBegin;
+		std::atomic_bool _totalCCErrorsBeginSet;
 		bool _changed;
-		PidData _data[MAX_PIDS];
+		std::atomic_bool _allPIDs;
+		std::atomic<uint64_t> _opened[OPENED_WORDS]; /// hot: the opened PIDs
+		State _state[MAX_PIDS];
+		/// The slot of each PID (or NO_SLOT), a page only for opened PID ranges
+		std::atomic<std::atomic<uint16_t> *> _slotPages[PAGES];
+		/// The counters by slot, a page only for the slots in use
+		std::atomic<PidStats *> _statsPages[PAGES];
+		uint16_t _usedSlots;
+		std::vector<uint16_t> _freeSlots;
 };
 
 }
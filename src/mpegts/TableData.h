@@ -25,6 +25,7 @@
 #include <cstdint>
 #include <string>
 #include <map>
+#include <vector>
 
 namespace mpegts {
 
@@ -114,6 +115,29 @@ class TableData {
 		/// Get the associated PID of this table
 		int getAssociatedPID() const;
 
+		/// Check, without collecting it, if this TS packet begins a (current)
+		/// section of this collected table with an other version or CRC. The CRC
+		/// is only compared when the section fits in this TS packet.
+		/// @param tableID specifies the table ID of this table
+		/// @param data specifies the TS packet to check
+		bool isChangedSection(const int tableID, const unsigned char* data) const noexcept {
+			// Is it the begin of a section of this table, that is applicable now
+			if ((data[1] & 0x40) != 0x40 || data[4] != 0x00 || data[5] != tableID ||
+				(data[10] & 0x01) != 0x01) {
+				return false;
+			}
+			if (((data[10] & 0x3E) >> 1) != _version) {
+				return true;
+			}
+			const std::size_t sectionLength = ((data[6] & 0x0F) << 8) | data[7];
+			const std::size_t secNr = data[11];
+			if (sectionLength <= (188 - 4 - 4) && secNr < _sectionCRC.size()) { // 4 = TS Header  4 = CRC
+				const uint32_t crc = CRC(data, sectionLength);
+				return crc != _sectionCRC[secNr];
+			}
+			return false;
+		}
+
 	protected:
 
 		/// Add Table data that was collected
@@ -159,6 +183,15 @@ class TableData {
 		/// Check if all sections are collected
 		bool checkAllCollected() const noexcept;
 
+		/// Continue the CRC calculation of the section with the newly added data,
+		/// so it does not have to be done over the complete section at the end
+		/// @param tableData specifies the section that is being collected
+		static void updateCRC(Data &tableData) noexcept;
+
+		/// Check the CRC of the collected section and set it collected when valid
+		/// @return true if the CRC is valid
+		bool checkCRCAndSetCollected(FeID id, int tableID, Data &tableData);
+
 		// =========================================================================
 		//  -- Data members --------------------------------------------------------
 		// =========================================================================
@@ -172,6 +205,8 @@ class TableData {
 			int secNr;
 			int lastSecNr;
 			uint32_t crc;
+			uint32_t calcCRC;     /// CRC over the collected part of the section
+			std::size_t crcIndex; /// index in data up to where calcCRC is done
 			TSData data;
 			int cc;
 			int pid;
@@ -187,6 +222,8 @@ class TableData {
 		std::size_t _currentSectionNumber = 0;
 		mutable bool _collectingFinished = false;
 		std::map<int, Data> _dataTable;
+		int _version = -1;
+		std::vector<uint32_t> _sectionCRC;
 
 };
 
@@ -24,6 +24,8 @@
 #include <socket/SocketClient.h>
 #include <Stream.h>
 
+#include <algorithm>
+#include <bitset>
 #include <random>
 
 extern const char* const satpi_version;
@@ -47,7 +49,24 @@ StreamClient::StreamClient(FeID feID) :
 		_commandSeq(0),
 		_senderRtpPacketCnt(0),
 		_senderOctectPayloadCnt(0),
-		_payload(0.0) {
+		_payload(0.0),
+		_sendQueueSize(0),
+		_sendQueueHead(0),
+		_sendQueueCnt(0),
+		_overflowPolicy(OverflowPolicy::DROP_OLDEST),
+		_sendChunkSize(0),
+		_sendFlushDeadline(0),
+		_sendQueueInFlight(0),
+		_sendQueueSending(0),
+		_sendZeroCopy(false),
+		_zeroCopyActive(false),
+		_zeroCopyNextID(0),
+		_zeroCopyDone(0),
+		_zeroCopySocket(nullptr),
+		_zeroCopyFD(-1),
+		_sendQueuePaused(false),
+		_sendQueueDropped(0),
+		_pidFilter(false) {
 	std::random_device rd;
 	std::mt19937 gen(rd());
 	std::normal_distribution<> dist(0xffff, 0xffff);
@@ -67,6 +86,9 @@ void StreamClient::doAddToXML(std::string &xml) const {
 	ADD_XML_ELEMENT(xml, "httpPort", (_socketClient == nullptr) ? 0 : _socketClient->getSocketPort());
 	ADD_XML_ELEMENT(xml, "spc", _senderRtpPacketCnt.load());
 	ADD_XML_ELEMENT(xml, "clientPayload", _payload.load() / (1024.0 * 1024.0));
+	ADD_XML_ELEMENT(xml, "sendQueued", _sendQueueCnt.load());
+	ADD_XML_ELEMENT(xml, "sendQueueDropped", _sendQueueDropped.load());
+	ADD_XML_ELEMENT(xml, "zeroCopyActive", _zeroCopyActive.load() ? "yes" : "no");
 }
 
 void StreamClient::doFromXML(const std::string &UNUSED(xml)) {}
@@ -76,17 +98,16 @@ void StreamClient::doFromXML(const std::string &UNUSED(xml)) {}
 // =============================================================================
 
 bool StreamClient::processStreamingRequest(const SocketClient &client) {
-	// Split message into Headers
-	HeaderVector headers = client.getHeaders();
+	const HttpcRequest &request = client.getRequest();
 
 	// Save clients seq number
-	const std::string cseq = headers.getFieldParameter("CSeq");
-	if (!cseq.empty()) {
-		_commandSeq = std::stoi(cseq);
+	const std::string_view cseq = request.getHeaderField("CSeq");
+	if (!cseq.empty() && std::isdigit(cseq[0])) {
+		_commandSeq = std::stoi(std::string(cseq));
 	}
 
 	// Save clients User-Agent
-	const std::string userAgent = headers.getFieldParameter("User-Agent");
+	const std::string_view userAgent = request.getHeaderField("User-Agent");
 	if (!userAgent.empty()) {
 		_userAgent = userAgent;
 	}
@@ -123,7 +144,406 @@ void StreamClient::writeRTCPData(const std::string& attributeDescribeString) {
 	doWriteRTCPData(sr, srlen, sdes, sdeslen, app, applen);
 }
 
+void StreamClient::setSendZeroCopy(const bool enable) {
+	std::lock_guard<std::mutex> lock(_sendQueueMutex);
+	_sendZeroCopy = enable && !_zeroCopyActive;
+}
+
+void StreamClient::setPIDs(const mpegts::PidTable::PidSet& pids) {
+	std::lock_guard<std::mutex> lock(_sendQueueMutex);
+	_pids = pids;
+}
+
+mpegts::PidTable::PidSet StreamClient::getPIDs() const {
+	std::lock_guard<std::mutex> lock(_sendQueueMutex);
+	return _pids;
+}
+
+void StreamClient::setPIDFilter(const bool enable) {
+	std::lock_guard<std::mutex> lock(_sendQueueMutex);
+	_pidFilter = enable;
+}
+
+void StreamClient::setSendQueue(const std::size_t size, const OverflowPolicy policy,
+		const std::size_t chunkSize, const std::chrono::milliseconds flushDeadline) {
+	std::lock_guard<std::mutex> lock(_sendQueueMutex);
+	clearSendQueueLocked();
+	// Keep the queue while the kernel still uses it, the headers are in there
+	if (_sendQueueCnt == 0) {
+		_sendQueue.resize(size);
+		_sendQueueSize = size;
+	}
+	_overflowPolicy = policy;
+	_sendChunkSize = chunkSize;
+	_sendFlushDeadline = flushDeadline;
+}
+
+bool StreamClient::queueData(mpegts::PacketBuffer& buffer) {
+	std::lock_guard<std::mutex> lock(_sendQueueMutex);
+	if (_sendQueueSize == 0 || isSelfDestructing()) {
+		return false;
+	}
+	if (_sendQueuePaused) {
+		// Resume when the client did catch up again
+		if (_sendQueueCnt > _sendQueueSize / 2) {
+			++_sendQueueDropped;
+			return false;
+		}
+		SI_LOG_INFO("Frontend: @#1, Resume sending to @#2", _feID, _ipAddressOfStream);
+		_sendQueuePaused = false;
+	}
+	const uint8_t packetMask = getPIDFilterMask(buffer);
+	if (packetMask == 0) {
+		// Nothing of interest for this client
+		return false;
+	}
+	if (_sendQueueCnt == _sendQueueSize) {
+		switch (_overflowPolicy) {
+			case OverflowPolicy::DROP_OLDEST: {
+				// Do not drop data that is (partially) send or being send, that
+				// would break the stream
+				std::size_t drop = _sendQueueInFlight + _sendQueueSending;
+				if (drop < _sendQueueCnt && _sendQueue[(_sendQueueHead + drop) % _sendQueueSize].sent > 0) {
+					++drop;
+				}
+				if (drop >= _sendQueueCnt) {
+					// Everything is waiting on the kernel, so drop this buffer
+					++_sendQueueDropped;
+					return false;
+				}
+				removeQueuedData(drop);
+				++_sendQueueDropped;
+				break;
+			}
+			case OverflowPolicy::DISCONNECT:
+				SI_LOG_ERROR("Frontend: @#1, Send queue overflow, disconnecting @#2", _feID, _ipAddressOfStream);
+				selfDestruct();
+				clearSendQueueLocked();
+				return false;
+			case OverflowPolicy::PAUSE:
+				SI_LOG_INFO("Frontend: @#1, Send queue overflow, pause sending to @#2", _feID, _ipAddressOfStream);
+				_sendQueuePaused = true;
+				++_sendQueueDropped;
+				return false;
+		}
+	}
+	const long timestamp = base::TimeCounter::getTicks() * 90;
+	const size_t dataSize = (packetMask == 0xFF) ? buffer.getCurrentBufferSize() :
+		std::bitset<8>(packetMask).count() * mpegts::PacketBuffer::TS_PACKET_SIZE;
+
+	++_senderRtpPacketCnt;
+	_senderOctectPayloadCnt += dataSize;
+	_payload += dataSize;
+	_timestamp = timestamp;
+
+	unsigned char rtpHeader[mpegts::PacketBuffer::RTP_HEADER_LEN];
+	mpegts::PacketBuffer::makeRTPHeader(rtpHeader, _ssrc, _senderRtpPacketCnt, timestamp);
+
+	QueuedData &data = _sendQueue[(_sendQueueHead + _sendQueueCnt) % _sendQueueSize];
+	data.buffer = &buffer;
+	data.dataSize = dataSize;
+	data.packetMask = packetMask;
+	data.headerSize = doMakeQueuedHeader(data.header.data(), rtpHeader, dataSize);
+	data.sent = 0;
+	data.queued = std::chrono::steady_clock::now();
+	buffer.addQueuedReference();
+	++_sendQueueCnt;
+	return true;
+}
+
+bool StreamClient::flushSendQueue() {
+	std::unique_lock<std::mutex> lock(_sendQueueMutex);
+	if (doSendsQueuedDatagrams()) {
+		return flushSendQueueDatagrams(lock);
+	}
+	if (_sendZeroCopy) {
+		_sendZeroCopy = false;
+		lock.unlock();
+		const bool active = _socketClient != nullptr && _socketClient->enableZeroCopy();
+		lock.lock();
+		_zeroCopyActive = active;
+		if (_zeroCopyActive) {
+			// The completions are read from this socket, also after a teardown
+			_zeroCopySocket = _socketClient;
+			_zeroCopyFD = _socketClient->getFD();
+			SI_LOG_INFO("Frontend: @#1, Using zero copy send to @#2", _feID, _ipAddressOfStream);
+		}
+	}
+	if (_sendQueueInFlight > 0 && !releaseZeroCopyCompletions(lock)) {
+		// The socket is closed, so the kernel does not use the data anymore
+		releaseSendQueueLocked();
+		return false;
+	}
+	iovec iov[MAX_CHUNK_IOV];
+	while (_sendQueueCnt > _sendQueueInFlight) {
+		if (!isSendChunkReady()) {
+			// Try again later, when there is more data or the deadline passed
+			return true;
+		}
+		// Collect the queued buffers up until one chunk, and skip what was
+		// already send of the first buffer
+		const std::size_t first = _sendQueueHead + _sendQueueInFlight;
+		const std::size_t unsent = _sendQueueCnt - _sendQueueInFlight;
+		int iovcnt = 0;
+		std::size_t chunkSize = 0;
+		std::size_t entries = 0;
+		std::size_t skip = _sendQueue[first % _sendQueueSize].sent;
+		for (std::size_t i = 0; i < unsent && iovcnt + MAX_QUEUED_IOV <= MAX_CHUNK_IOV; ++i) {
+			QueuedData &data = _sendQueue[(first + i) % _sendQueueSize];
+			iovec part[MAX_QUEUED_IOV];
+			const std::size_t partCnt = makeQueuedDataIov(data, part);
+			++entries;
+			for (std::size_t j = 0; j < partCnt; ++j) {
+				iovec &entry = part[j];
+				if (skip >= entry.iov_len) {
+					skip -= entry.iov_len;
+					continue;
+				}
+				entry.iov_base = static_cast<unsigned char *>(entry.iov_base) + skip;
+				entry.iov_len -= skip;
+				skip = 0;
+				iov[iovcnt++] = entry;
+				chunkSize += entry.iov_len;
+			}
+			if (chunkSize >= _sendChunkSize) {
+				break;
+			}
+		}
+		// Do not hold the lock while sending, the entries being send are
+		// not removed by the reader meanwhile
+		_sendQueueSending = entries;
+		lock.unlock();
+		ssize_t size = doSendQueuedData(iov, iovcnt);
+		lock.lock();
+		_sendQueueSending = 0;
+		if (size < 0) {
+			// Keep trying to get the completions of what is still in flight
+			clearSendQueueLocked();
+			return _sendQueueInFlight > 0;
+		} else if (size == 0) {
+			return true;
+		}
+		// With zero copy the kernel still uses the send data, until it reports
+		// the completion of this send call
+		const uint32_t zeroCopyID = _zeroCopyActive ? _zeroCopyNextID++ : 0;
+		while (size > 0) {
+			QueuedData &data = _sendQueue[(_sendQueueHead + _sendQueueInFlight) % _sendQueueSize];
+			const std::size_t left = data.headerSize + data.dataSize - data.sent;
+			data.zeroCopyID = zeroCopyID;
+			if (static_cast<std::size_t>(size) < left) {
+				data.sent += size;
+				break;
+			}
+			size -= left;
+			data.sent += left;
+			if (_zeroCopyActive) {
+				++_sendQueueInFlight;
+			} else {
+				removeQueuedData(_sendQueueInFlight);
+			}
+		}
+	}
+	// Keep trying while the kernel did not complete the zero copy sends
+	return _sendQueueInFlight > 0;
+}
+
+bool StreamClient::releaseZeroCopyCompletions(std::unique_lock<std::mutex> &lock) {
+	if (_zeroCopySocket == nullptr || _zeroCopySocket->getFD() != _zeroCopyFD) {
+		return false;
+	}
+	// Read the completions without the lock, only this writer changes the
+	// data in flight
+	SocketClient *socket = _zeroCopySocket;
+	bool completed = false;
+	bool copiedByKernel = false;
+	uint32_t done = 0;
+	lock.unlock();
+	uint32_t begin;
+	uint32_t end;
+	bool copied;
+	while (socket->readZeroCopyCompletion(begin, end, copied) == 1) {
+		completed = true;
+		done = end + 1;
+		copiedByKernel = copiedByKernel || copied;
+	}
+	lock.lock();
+	if (!completed) {
+		// On a read error the kernel may still use the data, so keep it until
+		// the socket is closed
+		return true;
+	}
+	_zeroCopyDone = done;
+	if (copiedByKernel && _zeroCopyActive) {
+		// The kernel did copy the data anyway (like on loopback), so stop
+		// using zero copy because it is only overhead then
+		SI_LOG_INFO("Frontend: @#1, Zero copy send to @#2 is copied by the kernel, not using it anymore",
+			_feID, _ipAddressOfStream);
+		_zeroCopyActive = false;
+	}
+	// Send calls are completed in order, so release from the oldest
+	while (_sendQueueInFlight > 0 &&
+			static_cast<int32_t>(_sendQueue[_sendQueueHead].zeroCopyID - _zeroCopyDone) < 0) {
+		--_sendQueueInFlight;
+		removeQueuedData(0);
+	}
+	return true;
+}
+
+uint8_t StreamClient::getPIDFilterMask(const mpegts::PacketBuffer& buffer) const {
+	if (!_pidFilter || _pids.test(mpegts::PidTable::ALL_PIDS)) {
+		return 0xFF;
+	}
+	const std::size_t packets = buffer.getNumberOfCompletedPackets();
+	uint8_t mask = 0;
+	for (std::size_t i = 0; i < packets; ++i) {
+		const unsigned char *ts = buffer.getTSPacketPtr(i);
+		const int pid = ((ts[1] & 0x1F) << 8) | ts[2];
+		// Keep the NULL packets, they are used to keep the client alive
+		if (pid == 0x1FFF || _pids.test(pid)) {
+			mask |= (1 << i);
+		}
+	}
+	return (mask == (1 << packets) - 1) ? 0xFF : mask;
+}
+
+std::size_t StreamClient::makeQueuedDataIov(QueuedData& data, struct iovec* iov) const {
+	iov[0].iov_base = data.header.data();
+	iov[0].iov_len = data.headerSize;
+	if (data.packetMask == 0xFF) {
+		iov[1].iov_base = data.buffer->getTSReadBufferPtr();
+		iov[1].iov_len = data.dataSize;
+		return 2;
+	}
+	// One iovec for each run of TS packets that passed the PID filter
+	std::size_t iovcnt = 1;
+	for (std::size_t i = 0; i < mpegts::PacketBuffer::NUMBER_OF_TS_PACKETS; ++i) {
+		if ((data.packetMask & (1 << i)) == 0) {
+			continue;
+		}
+		if (i > 0 && (data.packetMask & (1 << (i - 1))) != 0) {
+			iov[iovcnt - 1].iov_len += mpegts::PacketBuffer::TS_PACKET_SIZE;
+		} else {
+			iov[iovcnt].iov_base = data.buffer->getTSPacketPtr(i);
+			iov[iovcnt].iov_len = mpegts::PacketBuffer::TS_PACKET_SIZE;
+			++iovcnt;
+		}
+	}
+	return iovcnt;
+}
+
+void StreamClient::removeQueuedData(const std::size_t index) {
+	_sendQueue[(_sendQueueHead + index) % _sendQueueSize].buffer->releaseQueuedReference();
+	if (index == 0) {
+		_sendQueueHead = (_sendQueueHead + 1) % _sendQueueSize;
+	} else {
+		// Move the newer data one place, so the older (in flight) data stays in place
+		for (std::size_t i = index + 1; i < _sendQueueCnt; ++i) {
+			_sendQueue[(_sendQueueHead + i - 1) % _sendQueueSize] = _sendQueue[(_sendQueueHead + i) % _sendQueueSize];
+		}
+	}
+	--_sendQueueCnt;
+}
+
+bool StreamClient::isSendChunkReady() const {
+	const QueuedData &first = _sendQueue[(_sendQueueHead + _sendQueueInFlight) % _sendQueueSize];
+	if (_sendChunkSize == 0 || first.sent > 0) {
+		return true;
+	}
+	// Do not wait until the queue overflows
+	if (_sendQueueCnt >= _sendQueueSize - (_sendQueueSize / 4)) {
+		return true;
+	}
+	if (std::chrono::steady_clock::now() - first.queued >= _sendFlushDeadline) {
+		return true;
+	}
+	std::size_t size = 0;
+	for (std::size_t i = _sendQueueInFlight; i < _sendQueueCnt; ++i) {
+		const QueuedData &data = _sendQueue[(_sendQueueHead + i) % _sendQueueSize];
+		size += data.headerSize + data.dataSize;
+		if (size >= _sendChunkSize) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool StreamClient::flushSendQueueDatagrams(std::unique_lock<std::mutex> &lock) {
+	iovec iov[SocketAttr::MAX_SEND_DATAGRAMS * MAX_QUEUED_IOV];
+	while (_sendQueueCnt > 0) {
+		// Datagrams are send completely or not, so there is no partial data
+		const std::size_t count = std::min<std::size_t>(_sendQueueCnt, SocketAttr::MAX_SEND_DATAGRAMS);
+		for (std::size_t i = 0; i < count; ++i) {
+			QueuedData &data = _sendQueue[(_sendQueueHead + i) % _sendQueueSize];
+			iovec *entry = &iov[i * MAX_QUEUED_IOV];
+			for (std::size_t j = makeQueuedDataIov(data, entry); j < MAX_QUEUED_IOV; ++j) {
+				entry[j].iov_base = nullptr;
+				entry[j].iov_len = 0;
+			}
+		}
+		// Do not hold the lock while sending, @see flushSendQueue
+		_sendQueueSending = count;
+		lock.unlock();
+		const int sent = doSendQueuedDatagrams(iov, count);
+		lock.lock();
+		_sendQueueSending = 0;
+		if (sent < 0) {
+			clearSendQueueLocked();
+			return false;
+		}
+		for (int i = 0; i < sent; ++i) {
+			_sendQueue[_sendQueueHead].buffer->releaseQueuedReference();
+			_sendQueueHead = (_sendQueueHead + 1) % _sendQueueSize;
+			--_sendQueueCnt;
+		}
+		if (sent == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void StreamClient::clearSendQueue() {
+	std::lock_guard<std::mutex> lock(_sendQueueMutex);
+	clearSendQueueLocked();
+}
+
+void StreamClient::clearSendQueueLocked() {
+	// The data being send by a writer stays, it takes care of it
+	std::size_t keep = _sendQueueInFlight + _sendQueueSending;
+	// With zero copy a partially send buffer is also used by the kernel
+	if (_sendQueueSending == 0 && keep < _sendQueueCnt && _zeroCopyActive &&
+			_sendQueue[(_sendQueueHead + keep) % _sendQueueSize].sent > 0) {
+		++keep;
+	}
+	// Remove the newest first, so the data in flight stays in place
+	for (; _sendQueueCnt > keep; --_sendQueueCnt) {
+		_sendQueue[(_sendQueueHead + _sendQueueCnt - 1) % _sendQueueSize].buffer->releaseQueuedReference();
+	}
+	if (_sendQueueCnt == 0) {
+		_sendQueueHead = 0;
+	}
+	if (_sendQueueSending == 0) {
+		_sendQueueInFlight = keep;
+	}
+	_sendQueuePaused = false;
+}
+
+void StreamClient::releaseSendQueueLocked() {
+	for (; _sendQueueCnt > 0; --_sendQueueCnt) {
+		_sendQueue[_sendQueueHead].buffer->releaseQueuedReference();
+		_sendQueueHead = (_sendQueueHead + 1) % _sendQueueSize;
+	}
+	_sendQueueHead = 0;
+	_sendQueueInFlight = 0;
+	_sendQueuePaused = false;
+}
+
 void StreamClient::teardown() {
+	// The socket may still be open, so the data in flight stays queued until
+	// the kernel completed it or the socket is closed @see flushSendQueue
+	clearSendQueue();
+	setPIDFilter(false);
+	setPIDs(mpegts::PidTable::PidSet());
 	doTeardown();
 	{
 		base::MutexLock lock(_mutex);
@@ -360,6 +780,10 @@ bool StreamClient::writeHttpData(const struct iovec *iov, int iovcnt) {
 	return (_socketClient == nullptr) ? false : _socketClient->writeData(iov, iovcnt);
 }
 
+ssize_t StreamClient::writeHttpDataNonBlocking(const struct iovec *iov, int iovcnt) {
+	return (_socketClient == nullptr) ? -1 : _socketClient->writeDataNonBlocking(iov, iovcnt, _zeroCopyActive);
+}
+
 int StreamClient::getHttpSocketPort() const {
 //	base::MutexLock lock(_mutex);
 	return (_socketClient == nullptr) ? 0 : _socketClient->getSocketPort();
@@ -26,13 +26,18 @@
 #include <base/Mutex.h>
 #include <base/XMLSupport.h>
 #include <mpegts/PacketBuffer.h>
+#include <mpegts/PidTable.h>
 #include <socket/SocketAttr.h>
 #include <socket/SocketClient.h>
 #include <Stream.h>
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <ctime>
+#include <mutex>
 #include <string>
+#include <vector>
 
 FW_DECL_SP_NS1(output, StreamClient);
 
@@ -48,6 +53,13 @@ class StreamClient : public base::XMLSupport {
 			TEARDOWN
 		};
 
+		// Specifies what to do when the send queue of this client is full
+		enum class OverflowPolicy {
+			DROP_OLDEST,
+			DISCONNECT,
+			PAUSE
+		};
+
 		enum class StreamingType {
 			NONE,
 			HTTP,
@@ -88,12 +100,68 @@ class StreamClient : public base::XMLSupport {
 		///
 		void startStreaming();
 
+		/// Check if this client is started, and can receive data
+		bool isStreamActive() const {
+			return _streamActive;
+		}
+
 		///
 		bool writeData(mpegts::PacketBuffer& buffer);
 
 		///
 		void writeRTCPData(const std::string& attributeDescribeString);
 
+		/// Setup the send queue of this client
+		/// @param size specifies the maximum amount of queued buffers, 0 means
+		/// the data is written directly with @see writeData
+		/// @param policy specifies what to do when the queue is full
+		/// @param chunkSize specifies the amount of bytes a TCP client collects
+		/// before writing them at once, 0 means write all queued data directly
+		/// @param flushDeadline specifies the maximum time data waits for a chunk
+		void setSendQueue(std::size_t size, OverflowPolicy policy,
+			std::size_t chunkSize, std::chrono::milliseconds flushDeadline);
+
+		/// Use zero copy transmit (MSG_ZEROCOPY) for the queued data of TCP
+		/// clients. The queued buffers are then released when the kernel
+		/// reports it is done with them.
+		void setSendZeroCopy(bool enable);
+
+		/// Set the PIDs this client requested, only used for sharing the stream
+		/// with other clients @see setPIDFilter
+		void setPIDs(const mpegts::PidTable::PidSet& pids);
+
+		/// Get the PIDs this client requested
+		mpegts::PidTable::PidSet getPIDs() const;
+
+		/// Only send the TS packets of the requested PIDs (and NULL packets) to
+		/// this client, this is needed when the stream is shared and the device
+		/// gives the PIDs of all clients. Only possible with the send queue.
+		void setPIDFilter(bool enable);
+
+		/// Check if the data of this client should be queued with @see queueData
+		bool isSendQueueEnabled() const {
+			return _sendQueueSize > 0;
+		}
+
+		/// Queue the buffer, it will be send later by @see flushSendQueue.
+		/// The buffer should not be reused until it is released by the queue.
+		/// @return false if the buffer was not queued
+		bool queueData(mpegts::PacketBuffer& buffer);
+
+		/// Send the queued data without blocking
+		/// @return true when the socket would block with data still queued
+		bool flushSendQueue();
+
+		/// Remove the queued data that is not send yet and release the buffers.
+		/// The data that the kernel still uses with zero copy stays queued
+		/// until its completion is read by @see flushSendQueue
+		void clearSendQueue();
+
+		/// Check if there is still data in the send queue
+		bool hasQueuedData() const {
+			return _sendQueueCnt != 0;
+		}
+
 		///
 		void teardown();
 
@@ -170,6 +238,40 @@ class StreamClient : public base::XMLSupport {
 			return false;
 		}
 
+		/// Make the header that is send before the TS packets of a queued buffer
+		/// @param header specifies where to write, room for MAX_QUEUED_HEADER_LEN
+		/// @param rtpHeader specifies the RTP header of this buffer
+		/// @param dataSize specifies the amount of TS data of this buffer
+		/// @return the size of the header
+		virtual std::size_t doMakeQueuedHeader(
+				unsigned char* UNUSED(header),
+				const unsigned char* UNUSED(rtpHeader),
+				std::size_t UNUSED(dataSize)) const {
+			return 0;
+		}
+
+		/// Send the queued data without blocking
+		/// @return the amount of bytes send, 0 when it would block and -1 on an error
+		virtual ssize_t doSendQueuedData(const struct iovec* UNUSED(iov), int UNUSED(iovcnt)) {
+			return -1;
+		}
+
+		/// Check if the queued data is send as datagrams, then several queued
+		/// buffers are send at once with @see doSendQueuedDatagrams
+		virtual bool doSendsQueuedDatagrams() const {
+			return false;
+		}
+
+		/// Send several queued buffers as datagrams without blocking
+		/// @param iov specifies MAX_QUEUED_IOV iovec (header and TS packets) for
+		/// each datagram, unused iovec have a zero length
+		/// @param count specifies the amount of datagrams
+		/// @return the amount of datagrams send, 0 when it would block and -1 on an error
+		virtual int doSendQueuedDatagrams(const struct iovec* UNUSED(iov),
+				std::size_t UNUSED(count)) {
+			return -1;
+		}
+
 		///
 		virtual void doWriteRTCPData(
 				const PacketPtr& UNUSED(sr), int UNUSED(srlen),
@@ -202,6 +304,10 @@ class StreamClient : public base::XMLSupport {
 		/// Send HTTP/RTP_TCP data to connected client
 		bool writeHttpData(const struct iovec *iov, int iovcnt);
 
+		/// Send HTTP/RTP_TCP data to connected client without blocking, with
+		/// zero copy when that is active for this client
+		ssize_t writeHttpDataNonBlocking(const struct iovec *iov, int iovcnt);
+
 		/// Get the HTTP/RTP_TCP port of the connected client
 		int getHttpSocketPort() const;
 
@@ -218,7 +324,7 @@ class StreamClient : public base::XMLSupport {
 
 		base::Mutex  _mutex;
 		FeID _feID;
-		bool _streamActive;
+		std::atomic_bool _streamActive;
 		SocketClient *_socketClient;
 		SessionTimeoutCheck _sessionTimeoutCheck;
 		std::string _ipAddressOfStream;
@@ -235,6 +341,85 @@ class StreamClient : public base::XMLSupport {
 		std::atomic<long> _timestamp;
 		std::atomic<long> _payload;
 
+		static constexpr std::size_t MAX_QUEUED_HEADER_LEN = 4 + mpegts::PacketBuffer::RTP_HEADER_LEN;
+
+		/// The maximum amount of iovec for one queued buffer, the header and the
+		/// runs of TS packets that pass the PID filter (1 + 4 out of 7 packets)
+		static constexpr std::size_t MAX_QUEUED_IOV = 1 + ((mpegts::PacketBuffer::NUMBER_OF_TS_PACKETS + 1) / 2);
+
+	private:
+
+		/// Send the queued data as datagrams, @see flushSendQueue
+		bool flushSendQueueDatagrams(std::unique_lock<std::mutex> &lock);
+
+		/// @see clearSendQueue, @c _sendQueueMutex should be locked
+		void clearSendQueueLocked();
+
+		/// Check if there is enough queued data for one chunk, or if the
+		/// oldest data waits too long already
+		bool isSendChunkReady() const;
+
+		/// Remove all queued data and release the buffers, also the data in
+		/// flight. Only by the writer when the socket is closed, and
+		/// @c _sendQueueMutex should be locked
+		void releaseSendQueueLocked();
+
+		/// Read the zero copy completions and release the queued data that
+		/// the kernel is done with. The lock is released while reading.
+		/// @return false when the socket is closed
+		bool releaseZeroCopyCompletions(std::unique_lock<std::mutex> &lock);
+
+		/// Get the TS packets of the buffer that pass the PID filter of this client
+		/// @return the mask with one bit for each TS packet in the buffer
+		uint8_t getPIDFilterMask(const mpegts::PacketBuffer& buffer) const;
+
+		/// Remove queued data and release its buffer
+		/// @param index specifies the position from the oldest queued data
+		void removeQueuedData(std::size_t index);
+
+		struct QueuedData {
+			mpegts::PacketBuffer *buffer;
+			std::size_t dataSize;
+			uint8_t packetMask;
+			std::size_t headerSize;
+			std::size_t sent;
+			uint32_t zeroCopyID;
+			std::chrono::steady_clock::time_point queued;
+			std::array<unsigned char, MAX_QUEUED_HEADER_LEN> header;
+		};
+
+		/// Make the iovec of one queued buffer, the header and TS packets
+		/// @param iov specifies where to write, room for MAX_QUEUED_IOV
+		/// @return the amount of iovec
+		std::size_t makeQueuedDataIov(QueuedData& data, struct iovec* iov) const;
+
+		/// The maximum amount of iovec for writing one chunk
+		static constexpr std::size_t MAX_CHUNK_IOV = 512;
+
+		/// Guards the send queue, it is never held during a send call
+		mutable std::mutex _sendQueueMutex;
+		std::vector<QueuedData> _sendQueue;
+		std::size_t _sendQueueSize;
+		std::size_t _sendQueueHead;
+		std::atomic<std::size_t> _sendQueueCnt;
+		OverflowPolicy _overflowPolicy;
+		std::size_t _sendChunkSize;
+		std::chrono::milliseconds _sendFlushDeadline;
+		std::size_t _sendQueueInFlight;
+		/// The amount of entries, after the ones in flight, that a writer is sending
+		std::size_t _sendQueueSending;
+		bool _sendZeroCopy;
+		std::atomic_bool _zeroCopyActive;
+		uint32_t _zeroCopyNextID;
+		uint32_t _zeroCopyDone;
+		/// The socket (and its fd) that the zero copy completions are read from
+		SocketClient *_zeroCopySocket;
+		int _zeroCopyFD;
+		bool _sendQueuePaused;
+		std::atomic<std::size_t> _sendQueueDropped;
+		mpegts::PidTable::PidSet _pids;
+		bool _pidFilter;
+
 };
 
 }
@@ -62,4 +62,20 @@ bool StreamClientOutputHttp::doWriteData(mpegts::PacketBuffer& buffer) {
 	return true;
 }
 
+std::size_t StreamClientOutputHttp::doMakeQueuedHeader(unsigned char* UNUSED(header),
+		const unsigned char* UNUSED(rtpHeader), std::size_t UNUSED(dataSize)) const {
+	// HTTP sends only the TS packets
+	return 0;
+}
+
+ssize_t StreamClientOutputHttp::doSendQueuedData(const struct iovec* iov, const int iovcnt) {
+	const ssize_t size = writeHttpDataNonBlocking(iov, iovcnt);
+	if (size < 0 && !isSelfDestructing()) {
+		SI_LOG_ERROR("Frontend: @#1, Error sending HTTP Stream Data to @#2:@#3", _feID,
+			_ipAddressOfStream, getHttpSocketPort());
+		selfDestruct();
+	}
+	return size;
+}
+
 }
@@ -19,6 +19,10 @@
 */
 #include <output/StreamClientOutputRtp.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
 extern const char* const satpi_version;
 
 namespace output {
@@ -90,8 +94,7 @@ std::string StreamClientOutputRtp::getSDPMediaLevelString(
 }
 
 bool StreamClientOutputRtp::doProcessStreamingRequest(const SocketClient& client) {
-	// Split message into Headers
-	HeaderVector headers = client.getHeaders();
+	const HeaderVector &headers = client.getHeaders();
 
 	std::string ports;
 	int ttl = 0;
@@ -147,10 +150,13 @@ void StreamClientOutputRtp::doTeardown() {
 }
 
 bool StreamClientOutputRtp::doWriteData(mpegts::PacketBuffer& buffer) {
-	const size_t dataSize = buffer.getCurrentBufferSize();
-	const size_t lenRTP = dataSize + mpegts::PacketBuffer::RTP_HEADER_LEN;
-	const unsigned char* rtpBuffer = buffer.getReadBufferPtr();
-	if (!_rtp.sendDataTo(rtpBuffer, lenRTP, MSG_DONTWAIT)) {
+	// RTP header and TS packets are not necessarily contiguous (mmap capture)
+	iovec iov[2];
+	iov[0].iov_base = buffer.getRTPHeaderPtr();
+	iov[0].iov_len = mpegts::PacketBuffer::RTP_HEADER_LEN;
+	iov[1].iov_base = buffer.getTSReadBufferPtr();
+	iov[1].iov_len = buffer.getCurrentBufferSize();
+	if (!_rtp.sendDataTo(iov, 2, MSG_DONTWAIT)) {
 		if (!isSelfDestructing()) {
 			SI_LOG_ERROR("Frontend: @#1, Error sending RTP/UDP data to @#2:@#3", _feID,
 				_rtp.getIPAddressOfSocket(), _rtp.getSocketPort());
@@ -160,6 +166,84 @@ bool StreamClientOutputRtp::doWriteData(mpegts::PacketBuffer& buffer) {
 	return true;
 }
 
+std::size_t StreamClientOutputRtp::doMakeQueuedHeader(unsigned char* header,
+		const unsigned char* rtpHeader, std::size_t UNUSED(dataSize)) const {
+	std::memcpy(header, rtpHeader, mpegts::PacketBuffer::RTP_HEADER_LEN);
+	return mpegts::PacketBuffer::RTP_HEADER_LEN;
+}
+
+ssize_t StreamClientOutputRtp::doSendQueuedData(const struct iovec* iov, const int iovcnt) {
+	const ssize_t size = _rtp.sendDataToNonBlocking(iov, iovcnt);
+	if (size < 0 && !isSelfDestructing()) {
+		SI_LOG_ERROR("Frontend: @#1, Error sending RTP/UDP data to @#2:@#3", _feID,
+			_rtp.getIPAddressOfSocket(), _rtp.getSocketPort());
+		selfDestruct();
+	}
+	return size;
+}
+
+int StreamClientOutputRtp::doSendQueuedDatagrams(const struct iovec* iov, const std::size_t count) {
+	if (_udpSegmentation && count > 1) {
+		const int sent = sendSegmentedDatagrams(iov, count);
+		if (sent != -2) {
+			return sent;
+		}
+		_udpSegmentation = false;
+		SI_LOG_INFO("Frontend: @#1, UDP segmentation not usable for @#2:@#3, using sendmmsg", _feID,
+			_rtp.getIPAddressOfSocket(), _rtp.getSocketPort());
+	}
+	const int sent = _rtp.sendMultipleDataToNonBlocking(iov, MAX_QUEUED_IOV, count);
+	if (sent < 0 && !isSelfDestructing()) {
+		SI_LOG_ERROR("Frontend: @#1, Error sending RTP/UDP data to @#2:@#3", _feID,
+			_rtp.getIPAddressOfSocket(), _rtp.getSocketPort());
+		selfDestruct();
+	}
+	return sent;
+}
+
+int StreamClientOutputRtp::sendSegmentedDatagrams(const struct iovec* iov, const std::size_t count) {
+	// All datagrams should have the same size, only the last one may be smaller
+	const auto datagramSize = [iov](const std::size_t index) {
+		std::size_t size = 0;
+		for (std::size_t i = 0; i < MAX_QUEUED_IOV; ++i) {
+			size += iov[(index * MAX_QUEUED_IOV) + i].iov_len;
+		}
+		return size;
+	};
+	const std::size_t segmentSize = datagramSize(0);
+	const std::size_t maxSegments = std::min(SocketAttr::MAX_SEND_DATAGRAMS,
+		SocketAttr::MAX_UDP_PAYLOAD / segmentSize);
+	std::size_t segments = 1;
+	for (; segments < count && segments < maxSegments; ++segments) {
+		const std::size_t size = datagramSize(segments);
+		if (size > segmentSize) {
+			break;
+		} else if (size < segmentSize) {
+			++segments;
+			break;
+		}
+	}
+	if (segments == 1) {
+		return _rtp.sendMultipleDataToNonBlocking(iov, MAX_QUEUED_IOV, 1);
+	}
+	const ssize_t size = _rtp.sendSegmentedDataToNonBlocking(iov, segments * MAX_QUEUED_IOV, segmentSize);
+	if (size > 0) {
+		return segments;
+	} else if (size == 0) {
+		return 0;
+	}
+	// Not supported by the kernel or by the network device (no checksum offload)
+	if (errno == EIO || errno == EINVAL || errno == ENOPROTOOPT || errno == EOPNOTSUPP) {
+		return -2;
+	}
+	if (!isSelfDestructing()) {
+		SI_LOG_PERROR("Frontend: @#1, Error sending RTP/UDP data to @#2:@#3", _feID,
+			_rtp.getIPAddressOfSocket(), _rtp.getSocketPort());
+		selfDestruct();
+	}
+	return -1;
+}
+
 void StreamClientOutputRtp::doWriteRTCPData(
 		const PacketPtr& sr, const int srlen,
 		const PacketPtr& sdes, const int sdeslen,
@@ -79,6 +79,31 @@ class StreamClientOutputRtp : public output::StreamClient {
 		/// Specialization for @see writeData
 		virtual bool doWriteData(mpegts::PacketBuffer& buffer) final;
 
+		/// Specialization for @see queueData
+		virtual std::size_t doMakeQueuedHeader(unsigned char* header,
+				const unsigned char* rtpHeader, std::size_t dataSize) const final;
+
+		/// Specialization for @see flushSendQueue
+		virtual ssize_t doSendQueuedData(const struct iovec* iov, int iovcnt) final;
+
+		/// Specialization for @see flushSendQueue
+		virtual bool doSendsQueuedDatagrams() const final {
+			return true;
+		}
+
+		/// Specialization for @see flushSendQueue
+		virtual int doSendQueuedDatagrams(const struct iovec* iov, std::size_t count) final;
+
+		// =========================================================================
+		//  -- Other member functions ----------------------------------------------
+		// =========================================================================
+	private:
+
+		/// Send the first datagrams of the same size with UDP segmentation (GSO)
+		/// @return the amount of datagrams send, 0 when it would block, -1 on
+		/// an error and -2 when segmentation is not usable
+		int sendSegmentedDatagrams(const struct iovec* iov, std::size_t count);
+
 		/// Specialization for @see writeRTCPData
 		virtual void doWriteRTCPData(
 				const PacketPtr& sr, int srlen,
@@ -91,6 +116,7 @@ class StreamClientOutputRtp : public output::StreamClient {
 	private:
 
 		bool _multicast;
+		bool _udpSegmentation = true;
 
 };
 
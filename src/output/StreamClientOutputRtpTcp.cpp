@@ -19,6 +19,8 @@
 */
 #include <output/StreamClientOutputRtpTcp.h>
 
+#include <cstring>
+
 extern const char* const satpi_version;
 
 namespace output {
@@ -46,8 +48,7 @@ std::string StreamClientOutputRtpTcp::getSetupMethodReply(const StreamID streamI
 }
 
 bool StreamClientOutputRtpTcp::doProcessStreamingRequest(const SocketClient& client) {
-	// Split message into Headers
-	HeaderVector headers = client.getHeaders();
+	const HeaderVector &headers = client.getHeaders();
 
 	const int interleaved = headers.getIntFieldParameter("Transport", "interleaved");
 	if (interleaved != -1) {
@@ -87,14 +88,16 @@ bool StreamClientOutputRtpTcp::doWriteData(mpegts::PacketBuffer& buffer) {
 	header[2] = (lenRTP >> 8) & 0xFF;
 	header[3] = (lenRTP >> 0) & 0xFF;
 
-	iovec iov[2];
+	iovec iov[3];
 	iov[0].iov_base = header;
 	iov[0].iov_len = 4;
-	iov[1].iov_base = buffer.getReadBufferPtr();
-	iov[1].iov_len = lenRTP;
+	iov[1].iov_base = buffer.getRTPHeaderPtr();
+	iov[1].iov_len = mpegts::PacketBuffer::RTP_HEADER_LEN;
+	iov[2].iov_base = buffer.getTSReadBufferPtr();
+	iov[2].iov_len = dataSize;
 
 	// send the RTP/TCP packet
-	if (!writeHttpData(iov, 2)) {
+	if (!writeHttpData(iov, 3)) {
 		if (!isSelfDestructing()) {
 			SI_LOG_ERROR("Frontend: @#1, Error sending RTP/TCP Stream Data to @#2:@#3", _feID,
 				_ipAddressOfStream, getHttpSocketPort());
@@ -104,6 +107,27 @@ bool StreamClientOutputRtpTcp::doWriteData(mpegts::PacketBuffer& buffer) {
 	return true;
 }
 
+std::size_t StreamClientOutputRtpTcp::doMakeQueuedHeader(unsigned char* header,
+		const unsigned char* rtpHeader, const std::size_t dataSize) const {
+	const size_t lenRTP = dataSize + mpegts::PacketBuffer::RTP_HEADER_LEN;
+	header[0] = 0x24;
+	header[1] = 0x00;
+	header[2] = (lenRTP >> 8) & 0xFF;
+	header[3] = (lenRTP >> 0) & 0xFF;
+	std::memcpy(header + 4, rtpHeader, mpegts::PacketBuffer::RTP_HEADER_LEN);
+	return 4 + mpegts::PacketBuffer::RTP_HEADER_LEN;
+}
+
+ssize_t StreamClientOutputRtpTcp::doSendQueuedData(const struct iovec* iov, const int iovcnt) {
+	const ssize_t size = writeHttpDataNonBlocking(iov, iovcnt);
+	if (size < 0 && !isSelfDestructing()) {
+		SI_LOG_ERROR("Frontend: @#1, Error sending RTP/TCP Stream Data to @#2:@#3", _feID,
+			_ipAddressOfStream, getHttpSocketPort());
+		selfDestruct();
+	}
+	return size;
+}
+
 void StreamClientOutputRtpTcp::doWriteRTCPData(
 		const PacketPtr& sr, const int srlen,
 		const PacketPtr& sdes, const int sdeslen,
@@ -73,6 +73,13 @@ class StreamClientOutputRtpTcp : public output::StreamClient {
 		/// Specialization for @see writeData
 		virtual bool doWriteData(mpegts::PacketBuffer& buffer) final;
 
+		/// Specialization for @see queueData
+		virtual std::size_t doMakeQueuedHeader(unsigned char* header,
+				const unsigned char* rtpHeader, std::size_t dataSize) const final;
+
+		/// Specialization for @see flushSendQueue
+		virtual ssize_t doSendQueuedData(const struct iovec* iov, int iovcnt) final;
+
 		/// Specialization for @see writeRTCPData
 		virtual void doWriteRTCPData(
 				const PacketPtr& sr, int srlen,
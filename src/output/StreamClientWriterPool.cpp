@@ -0,0 +1,114 @@
+/* StreamClientWriterPool.cpp
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <output/StreamClientWriterPool.h>
+
+#include <Log.h>
+#include <StringConverter.h>
+#include <output/StreamClient.h>
+
+#include <algorithm>
+
+namespace output {
+
+// =============================================================================
+//  -- Constructors and destructor ---------------------------------------------
+// =============================================================================
+
+StreamClientWriterPool::StreamClientWriterPool(const std::size_t numberOfThreads) {
+	for (std::size_t i = 0; i < numberOfThreads; ++i) {
+		_threads.push_back(std::make_unique<base::Thread>(
+			StringConverter::stringFormat("Writer@#1", i),
+			std::bind(&StreamClientWriterPool::threadExecuteWriter, this)));
+		_threads.back()->startThread();
+	}
+	SI_LOG_INFO("StreamClientWriterPool: Started with @#1 writer threads", _threads.size());
+}
+
+StreamClientWriterPool::~StreamClientWriterPool() {
+	_cond.notify_all();
+	_threads.clear();
+}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void StreamClientWriterPool::schedule(const SpStreamClient &client) {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		// A client is flushed by one writer at a time, so let that writer
+		// requeue it when it is done
+		const auto inFlight = std::find_if(_inFlight.begin(), _inFlight.end(),
+			[&client](const InFlight &entry) { return entry.client == client; });
+		if (inFlight != _inFlight.end()) {
+			inFlight->rescheduled = true;
+			return;
+		}
+		if (std::find(_pending.begin(), _pending.end(), client) != _pending.end() ||
+			std::find(_blocked.begin(), _blocked.end(), client) != _blocked.end()) {
+			return;
+		}
+		_pending.push_back(client);
+	}
+	_cond.notify_one();
+}
+
+bool StreamClientWriterPool::threadExecuteWriter() {
+	SpStreamClient client;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		// Give the blocked clients an other try after some time
+		if (!_blocked.empty() && Clock::now() - _blockedSince >= RETRY_INTERVAL) {
+			_pending.insert(_pending.end(), _blocked.begin(), _blocked.end());
+			_blocked.clear();
+		}
+		if (_pending.empty()) {
+			_cond.wait_for(lock, _blocked.empty() ? std::chrono::milliseconds(100) : RETRY_INTERVAL);
+			return true;
+		}
+		client = _pending.front();
+		_pending.pop_front();
+		_inFlight.push_back({client, false});
+	}
+	const bool blocked = client->flushSendQueue();
+	bool rescheduled = false;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		const auto inFlight = std::find_if(_inFlight.begin(), _inFlight.end(),
+			[&client](const InFlight &entry) { return entry.client == client; });
+		rescheduled = inFlight->rescheduled;
+		_inFlight.erase(inFlight);
+		if (rescheduled) {
+			// New data was queued during the flush, so try again right away
+			_pending.push_back(client);
+		} else if (blocked) {
+			if (_blocked.empty()) {
+				_blockedSince = Clock::now();
+			}
+			_blocked.push_back(client);
+		}
+	}
+	if (rescheduled) {
+		_cond.notify_one();
+	}
+	return true;
+}
+
+}
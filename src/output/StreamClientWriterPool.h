@@ -0,0 +1,100 @@
+/* StreamClientWriterPool.h
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef OUTPUT_STREAM_CLIENT_WRITER_POOL_H_INCLUDE
+#define OUTPUT_STREAM_CLIENT_WRITER_POOL_H_INCLUDE OUTPUT_STREAM_CLIENT_WRITER_POOL_H_INCLUDE
+
+#include <FwDecl.h>
+#include <base/Thread.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+FW_DECL_SP_NS1(output, StreamClient);
+FW_DECL_SP_NS1(output, StreamClientWriterPool);
+
+namespace output {
+
+/// The class @c StreamClientWriterPool sends the queued data of the
+/// StreamClients with a pool of writer threads, so a slow client can not
+/// stall the reader of the stream.
+class StreamClientWriterPool {
+		// =========================================================================
+		// -- Constructors and destructor ------------------------------------------
+		// =========================================================================
+	public:
+
+		/// @param numberOfThreads specifies the amount of writer threads to use
+		explicit StreamClientWriterPool(std::size_t numberOfThreads);
+
+		virtual ~StreamClientWriterPool();
+
+		StreamClientWriterPool(const StreamClientWriterPool&) = delete;
+
+		StreamClientWriterPool& operator=(const StreamClientWriterPool&) = delete;
+
+		// =========================================================================
+		//  -- Other member functions ----------------------------------------------
+		// =========================================================================
+	public:
+
+		/// Schedule the client to send its queued data
+		/// @param client specifies the client with queued data
+		void schedule(const SpStreamClient &client);
+
+	private:
+
+		/// Thread execute function @see base::Thread should @return true to
+		/// keep thread running and @return false will stop and then terminate this thread
+		bool threadExecuteWriter();
+
+		// =========================================================================
+		// -- Data members ---------------------------------------------------------
+		// =========================================================================
+	private:
+
+		using Clock = std::chrono::steady_clock;
+
+		/// A client that is being flushed by a writer
+		struct InFlight {
+			SpStreamClient client;
+			/// Set when the client was scheduled again during its flush
+			bool rescheduled;
+		};
+
+		/// Time to wait before trying a client again, when its socket would block
+		static constexpr std::chrono::milliseconds RETRY_INTERVAL{2};
+
+		std::mutex _mutex;
+		std::condition_variable _cond;
+		std::deque<SpStreamClient> _pending;
+		std::vector<SpStreamClient> _blocked;
+		std::vector<InFlight> _inFlight;
+		Clock::time_point _blockedSince;
+		std::vector<std::unique_ptr<base::Thread>> _threads;
+};
+
+}
+
+#endif // OUTPUT_STREAM_CLIENT_WRITER_POOL_H_INCLUDE
@@ -0,0 +1,94 @@
+/* HttpcParser.cpp
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <socket/HttpcParser.h>
+
+#include <cctype>
+
+#include <strings.h>
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+bool HttpcParser::nextMessage(std::string &msg) {
+	if (_error) {
+		return false;
+	}
+	if (_headerSize == 0) {
+		// Continue scanning where we stopped, but include the last 3 bytes
+		// because "\r\n\r\n" could be split over two reads
+		const std::size_t from = (_scanned < 3) ? 0 : _scanned - 3;
+		const std::string::size_type end = _buffer.find("\r\n\r\n", from);
+		if (end == std::string::npos) {
+			_scanned = _buffer.size();
+			_error = _scanned > MAX_HEADER_SIZE;
+			return false;
+		}
+		_headerSize = end + 4;
+		const long contentLength = getContentLength();
+		if (contentLength < 0 || _headerSize + contentLength > MAX_MESSAGE_SIZE) {
+			_error = true;
+			return false;
+		}
+		_messageSize = _headerSize + contentLength;
+	}
+	if (_buffer.size() < _messageSize) {
+		return false;
+	}
+	if (_buffer.size() == _messageSize) {
+		msg.swap(_buffer);
+		_buffer.clear();
+	} else {
+		msg.assign(_buffer, 0, _messageSize);
+		_buffer.erase(0, _messageSize);
+	}
+	restart();
+	return true;
+}
+
+long HttpcParser::getContentLength() const {
+	static constexpr char FIELD[] = "content-length:";
+	static constexpr std::size_t FIELD_SIZE = sizeof(FIELD) - 1;
+	// Check the begin of every header line, skipping the request line
+	std::size_t line = _buffer.find("\r\n");
+	while (line != std::string::npos && line + 2 < _headerSize) {
+		const std::size_t begin = line + 2;
+		line = _buffer.find("\r\n", begin);
+		if (line - begin < FIELD_SIZE || ::strncasecmp(&_buffer[begin], FIELD, FIELD_SIZE) != 0) {
+			continue;
+		}
+		long length = 0;
+		std::size_t i = begin + FIELD_SIZE;
+		while (i < line && _buffer[i] == ' ') {
+			++i;
+		}
+		if (i == line) {
+			return -1;
+		}
+		for (; i < line && std::isdigit(static_cast<unsigned char>(_buffer[i])); ++i) {
+			length = (length * 10) + (_buffer[i] - '0');
+			if (length > static_cast<long>(MAX_MESSAGE_SIZE)) {
+				return -1;
+			}
+		}
+		return length;
+	}
+	return 0;
+}
@@ -0,0 +1,106 @@
+/* HttpcParser.h
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef SOCKET_HTTPC_PARSER_H_INCLUDE
+#define SOCKET_HTTPC_PARSER_H_INCLUDE SOCKET_HTTPC_PARSER_H_INCLUDE
+
+#include <cstddef>
+#include <string>
+
+/// The class @c HttpcParser collects the received data of one connection and
+/// splits it into complete HTTP/RTSP messages. It keeps its state between
+/// the reads, so a message can arrive in any amount of parts, and every
+/// received byte is only scanned once for the end of the headers.
+class HttpcParser {
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		HttpcParser() = default;
+
+		virtual ~HttpcParser() = default;
+
+		// =====================================================================
+		//  -- Other member functions ------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Add received data
+		void addData(const char *data, std::size_t size) {
+			_buffer.append(data, size);
+		}
+
+		/// Get the next complete message
+		/// @param msg specifies the string to move the message into
+		/// @return true if there was a complete message
+		bool nextMessage(std::string &msg);
+
+		/// Check if the received data can not be a valid message, it is
+		/// too big or has an invalid 'Content-Length'
+		bool hasError() const {
+			return _error;
+		}
+
+		/// Check if there is received data that is not a complete message yet
+		bool hasPartialMessage() const {
+			return !_buffer.empty();
+		}
+
+		/// Drop all received data and any error, so it can be used for an
+		/// other connection
+		void clear() {
+			_buffer.clear();
+			_error = false;
+			restart();
+		}
+
+	private:
+
+		/// Restart for the next message
+		void restart() {
+			_scanned = 0;
+			_headerSize = 0;
+			_messageSize = 0;
+		}
+
+		/// Find the 'Content-Length' in the headers
+		/// @return the content length or -1 if invalid
+		long getContentLength() const;
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		/// Maximum size of the headers and of a complete message
+		static constexpr std::size_t MAX_HEADER_SIZE = 64 * 1024;
+		static constexpr std::size_t MAX_MESSAGE_SIZE = 1024 * 1024;
+
+		std::string _buffer;
+		/// Bytes of @c _buffer that are scanned for the end of the headers
+		std::size_t _scanned = 0;
+		/// Size of the headers including "\r\n\r\n", 0 when not found yet
+		std::size_t _headerSize = 0;
+		/// Size of the complete message, known when the headers are found
+		std::size_t _messageSize = 0;
+		bool _error = false;
+};
+
+#endif // SOCKET_HTTPC_PARSER_H_INCLUDE
@@ -0,0 +1,136 @@
+/* HttpcRequest.cpp
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#include <socket/HttpcRequest.h>
+
+#include <StringConverter.h>
+
+#include <cctype>
+
+#include <strings.h>
+
+namespace {
+
+	std::string_view trim(std::string_view str) {
+		while (!str.empty() && (str.front() == ' ' || str.front() == '\t')) {
+			str.remove_prefix(1);
+		}
+		while (!str.empty() && (str.back() == ' ' || str.back() == '\t')) {
+			str.remove_suffix(1);
+		}
+		return str;
+	}
+
+}
+
+// =============================================================================
+//  -- Constructors and destructor ---------------------------------------------
+// =============================================================================
+
+HttpcRequest::HttpcRequest() :
+	_hasQuery(false),
+	_headers(StringVector()),
+	_params(StringVector()) {}
+
+// =============================================================================
+//  -- Other member functions --------------------------------------------------
+// =============================================================================
+
+void HttpcRequest::parse(const std::string &msg) {
+	clear();
+	const std::string_view view(msg);
+	const std::string_view::size_type headerEnd = view.find("\r\n\r\n");
+	const std::string_view header = view.substr(0, headerEnd);
+	if (headerEnd != std::string_view::npos) {
+		_content = view.substr(headerEnd + 4);
+	}
+
+	// Split the headers once, the request line is the first one
+	StringVector lines;
+	std::string_view::size_type begin = 0;
+	while (begin < header.size()) {
+		std::string_view::size_type end = header.find("\r\n", begin);
+		if (end == std::string_view::npos) {
+			end = header.size();
+		}
+		const std::string_view line = header.substr(begin, end - begin);
+		if (!line.empty()) {
+			lines.emplace_back(line);
+			if (lines.size() > 1) {
+				const std::string_view::size_type colon = line.find(':');
+				if (colon != std::string_view::npos) {
+					_fields.emplace_back(trim(line.substr(0, colon)), trim(line.substr(colon + 1)));
+				}
+			}
+		}
+		begin = end + 2;
+	}
+	if (lines.empty()) {
+		return;
+	}
+
+	// Request line: <method> <uri> <protocol>/<version>
+	const std::string_view requestLine = header.substr(0, header.find("\r\n"));
+	std::string_view::size_type i = requestLine.find_first_not_of(' ');
+	const std::string_view::size_type methodEnd = requestLine.find(' ', i);
+	if (i != std::string_view::npos) {
+		for (; i < methodEnd && i < requestLine.size(); ++i) {
+			_method += std::toupper(static_cast<unsigned char>(requestLine[i]));
+		}
+	}
+	const std::string_view::size_type uriBegin = requestLine.find('/');
+	if (uriBegin != std::string_view::npos) {
+		const std::string_view::size_type uriEnd = requestLine.find(' ', uriBegin);
+		_uri = requestLine.substr(uriBegin, uriEnd - uriBegin);
+		const std::string_view::size_type query = _uri.find('?');
+		_hasQuery = query != std::string_view::npos && query + 1 < _uri.size();
+	}
+	const std::string_view::size_type protocolBegin = requestLine.find_last_of(' ');
+	const std::string_view::size_type protocolEnd = requestLine.find_last_of('/');
+	if (protocolBegin != std::string_view::npos && protocolEnd != std::string_view::npos &&
+			protocolEnd > protocolBegin) {
+		_protocol = requestLine.substr(protocolBegin + 1, protocolEnd - protocolBegin - 1);
+	}
+
+	// Decode the Transport Parameters once
+	_params = TransportParamVector(StringConverter::split(
+		StringConverter::getPercentDecoding(lines[0]), " /?&"));
+	_headers = HeaderVector(std::move(lines));
+}
+
+void HttpcRequest::clear() {
+	_method.clear();
+	_uri = std::string_view();
+	_protocol = std::string_view();
+	_content = std::string_view();
+	_hasQuery = false;
+	_fields.clear();
+	_headers = HeaderVector(StringVector());
+	_params = TransportParamVector(StringVector());
+}
+
+std::string_view HttpcRequest::getHeaderField(const std::string_view name) const {
+	for (const HeaderField &field : _fields) {
+		if (field.first.size() == name.size() &&
+				::strncasecmp(field.first.data(), name.data(), name.size()) == 0) {
+			return field.second;
+		}
+	}
+	return std::string_view();
+}
@@ -0,0 +1,115 @@
+/* HttpcRequest.h
+
+   Copyright (C) 2014 - 2026 Marc Postema (mpostema09 -at- gmail.com)
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+   Or, point your browser to http://www.gnu.org/copyleft/gpl.html
+*/
+#ifndef SOCKET_HTTPC_REQUEST_H_INCLUDE
+#define SOCKET_HTTPC_REQUEST_H_INCLUDE SOCKET_HTTPC_REQUEST_H_INCLUDE
+
+#include <HeaderVector.h>
+#include <TransportParamVector.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/// The class @c HttpcRequest is the parsed HTTP/RTSP message. It is made
+/// once per message, the views point into the message so it should stay
+/// unchanged while this request is used.
+class HttpcRequest {
+		// =====================================================================
+		// -- Constructors and destructor --------------------------------------
+		// =====================================================================
+	public:
+
+		HttpcRequest();
+
+		virtual ~HttpcRequest() = default;
+
+		HttpcRequest(const HttpcRequest&) = delete;
+
+		HttpcRequest& operator=(const HttpcRequest&) = delete;
+
+		// =====================================================================
+		//  -- Other member functions ------------------------------------------
+		// =====================================================================
+	public:
+
+		/// Parse the message
+		void parse(const std::string &msg);
+
+		/// Clear this request
+		void clear();
+
+		/// Get the method (upper case), like "GET" or "SETUP"
+		const std::string &getMethod() const {
+			return _method;
+		}
+
+		/// Get the requested resource, including the query
+		std::string_view getURI() const {
+			return _uri;
+		}
+
+		/// Get the protocol, like "HTTP" or "RTSP"
+		std::string_view getProtocol() const {
+			return _protocol;
+		}
+
+		/// Check if the URI has a query with Transport Parameters
+		bool hasQuery() const {
+			return _hasQuery;
+		}
+
+		/// Get the value of header field @p name (case insensitive)
+		/// @return the trimmed value, or an empty view if not found
+		std::string_view getHeaderField(std::string_view name) const;
+
+		/// Get the content after the headers
+		std::string_view getContent() const {
+			return _content;
+		}
+
+		/// Get the header lines, including the request line
+		const HeaderVector &getHeaders() const {
+			return _headers;
+		}
+
+		/// Get the Transport Parameters, percent decoded
+		const TransportParamVector &getTransportParameters() const {
+			return _params;
+		}
+
+		// =====================================================================
+		// -- Data members -----------------------------------------------------
+		// =====================================================================
+	private:
+
+		using HeaderField = std::pair<std::string_view, std::string_view>;
+
+		std::string _method;
+		std::string_view _uri;
+		std::string_view _protocol;
+		std::string_view _content;
+		bool _hasQuery;
+		std::vector<HeaderField> _fields;
+		HeaderVector _headers;
+		TransportParamVector _params;
+};
+
+#endif // SOCKET_HTTPC_REQUEST_H_INCLUDE
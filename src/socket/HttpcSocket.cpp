@@ -23,17 +23,10 @@
 #include <socket/SocketClient.h>
 #include <StringConverter.h>
 
-#include <chrono>
-#include <thread>
-
 #include <unistd.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
 
-	namespace {
-		const int HTTPC_TIMEOUT = 4;
-	}
-
 	// =========================================================================
 	//  -- Constructors and destructor -----------------------------------------
 	// =========================================================================
@@ -44,64 +37,37 @@
 	// =========================================================================
 
 	ssize_t HttpcSocket::recvHttpcMessage(SocketClient &client, int recv_flags) {
-		return recv_recvfrom_httpc_message(client, recv_flags, nullptr, nullptr);
-	}
-
-	ssize_t HttpcSocket::recvfromHttpcMessage(SocketClient &client, int recv_flags,
-		struct sockaddr_in *si_other, socklen_t *addrlen) {
-		return recv_recvfrom_httpc_message(client, recv_flags, si_other, addrlen);
-	}
-
-	ssize_t HttpcSocket::recv_recvfrom_httpc_message(SocketClient &client,
-		int recv_flags, struct sockaddr_in *si_other, socklen_t *addrlen) {
-		std::size_t read_len = 0;
-		std::size_t timeout = HTTPC_TIMEOUT;
-		bool done = false;
-		bool end = false;
-		std::size_t actualSize = 0;
-
-		client.clearMessage();
-
-		// read until we have '\r\n\r\n' (end of HTTP/RTSP message) then check
-		// if the header field 'Content-Length' is present
-		do {
-			char buf[1024];
-			const ssize_t size = ::recvfrom(client.getFD(), buf, sizeof(buf)-1, recv_flags, (struct sockaddr *)si_other, addrlen);
+		ssize_t read_len = 0;
+		// Read until the socket is empty, an edge-triggered socket is only
+		// signaled again for new data
+		for (;;) {
+			char buf[4096];
+			const ssize_t size = ::recv(client.getFD(), buf, sizeof(buf), recv_flags | MSG_DONTWAIT);
 			if (size > 0) {
 				read_len += size;
-				// terminate
-				buf[size] = 0;
-				client.addMessage(buf);
-				// reset timeout again
-				timeout = HTTPC_TIMEOUT;
-				// end of message "\r\n\r\n" ?
-				if (!end) {
-					const std::string::size_type headerSize = client.getRawMessage().find("\r\n\r\n");
-					end = headerSize != std::string::npos;
-
-					// check do we need to read more?
-					const std::string parameter = client.getHeaders().getFieldParameter("Content-Length");
-					const std::size_t contentLength = parameter.empty() ? 0 : std::stoi(parameter);
-					if (contentLength > 0) {
-						// now check did we read it all
-						actualSize = headerSize + contentLength + 4; // 4 = "\r\n\r\n"
-						done = actualSize == client.getRawMessage().size();
-					} else if (end) {
-						done = true;
-					}
-				} else {
-					// now check did we read it all this time around?
-					done = actualSize == client.getRawMessage().size();
-				}
+				client.addReceivedData(buf, size);
+			} else if (size == 0) {
+				// Connection closed, the data read so far can still be used
+				return 0;
+			} else if (errno == EINTR) {
+				continue;
+			} else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				return (read_len > 0) ? read_len : -1;
 			} else {
-				if (timeout != 0 && size == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
-					std::this_thread::sleep_for(std::chrono::milliseconds(500));
-					--timeout;
-				} else {
-					return size;
-				}
+				return -1;
 			}
-		} while (!done);
+		}
+	}
 
-		return read_len;
+	ssize_t HttpcSocket::recvfromHttpcMessage(SocketClient &client, int recv_flags,
+		struct sockaddr_in *si_other, socklen_t *addrlen) {
+		// One datagram is one message
+		char buf[4096];
+		const ssize_t size = ::recvfrom(client.getFD(), buf, sizeof(buf), recv_flags,
+			reinterpret_cast<struct sockaddr *>(si_other), addrlen);
+		client.clearMessage();
+		if (size > 0) {
+			client.addMessage(std::string(buf, size));
+		}
+		return size;
 	}
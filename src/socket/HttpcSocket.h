@@ -43,13 +43,17 @@ class HttpcSocket  {
 		// =========================================================================
 	protected:
 
-		/// Receive an HTTP message from client
+		/// Receive all available data of the HTTP messages from client,
+		/// without waiting for more. The complete messages can be taken
+		/// with @c SocketClient::nextMessage
 		/// @param client
 		/// @param recv_flags
-		/// @return the amount of bytes red
+		/// @return the amount of bytes red, 0 when the connection is closed or
+		/// -1 on an error. When there was no data, -1 is returned with errno
+		/// set to EAGAIN
 		ssize_t recvHttpcMessage(SocketClient &client, int recv_flags);
 
-		/// Receive an HTTP message from client
+		/// Receive one HTTP message (datagram) from client
 		/// @param client
 		/// @param recv_flags
 		/// @param si_other
@@ -58,11 +62,6 @@ class HttpcSocket  {
 		ssize_t recvfromHttpcMessage(SocketClient &client, int recv_flags,
 			struct sockaddr_in *si_other, socklen_t *addrlen);
 
-	private:
-		/// Main receive HTTP message from client
-		ssize_t recv_recvfrom_httpc_message(SocketClient &client, int recv_flags,
-			struct sockaddr_in *si_other, socklen_t *addrlen);
-
 };
 
 #endif
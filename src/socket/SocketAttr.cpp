@@ -23,18 +23,41 @@
 #include <StringConverter.h>
 #include <socket/SocketClient.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 #include <string>
 #include <thread>
 
 #include <arpa/inet.h>
+#include <netinet/udp.h>
+#include <linux/errqueue.h>
 #include <sys/uio.h>
 #include <sys/socket.h>
 #include <sys/select.h>
 #include <unistd.h>
 #include <fcntl.h>
 
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+
+#ifndef SO_EE_CODE_ZEROCOPY_COPIED
+#define SO_EE_CODE_ZEROCOPY_COPIED 1
+#endif
+
 	// ===================================================================
 	//  -- Constructors and destructor -----------------------------------
 	// ===================================================================
@@ -218,6 +241,141 @@
 		return true;
 	}
 
+	bool SocketAttr::sendDataTo(const iovec *iov, const int iovcnt, int flags) {
+		msghdr msg{};
+		msg.msg_name = &_addr;
+		msg.msg_namelen = sizeof(_addr);
+		msg.msg_iov = const_cast<iovec *>(iov);
+		msg.msg_iovlen = iovcnt;
+		if (::sendmsg(_fd, &msg, flags) == -1) {
+			SI_LOG_PERROR("sendmsg (fd: @#1)", _fd);
+			return false;
+		}
+		return true;
+	}
+
+	ssize_t SocketAttr::writeDataNonBlocking(const iovec *iov, const int iovcnt,
+			const bool zeroCopy) {
+		if (_fd == -1) {
+			return -1;
+		}
+		msghdr msg{};
+		msg.msg_iov = const_cast<iovec *>(iov);
+		msg.msg_iovlen = iovcnt;
+		const int flags = MSG_DONTWAIT | MSG_NOSIGNAL | (zeroCopy ? MSG_ZEROCOPY : 0);
+		base::MutexLock lock(_mutex);
+		const ssize_t size = ::sendmsg(_fd, &msg, flags);
+		if (size == -1) {
+			// ENOBUFS: To many zero copy sends are not completed yet
+			if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ||
+					(zeroCopy && errno == ENOBUFS)) {
+				return 0;
+			}
+			SI_LOG_PERROR("writeDataNonBlocking (fd: @#1)", _fd);
+		}
+		return size;
+	}
+
+	ssize_t SocketAttr::sendDataToNonBlocking(const iovec *iov, const int iovcnt) {
+		msghdr msg{};
+		msg.msg_name = &_addr;
+		msg.msg_namelen = sizeof(_addr);
+		msg.msg_iov = const_cast<iovec *>(iov);
+		msg.msg_iovlen = iovcnt;
+		const ssize_t size = ::sendmsg(_fd, &msg, MSG_DONTWAIT);
+		if (size == -1) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+				return 0;
+			}
+			SI_LOG_PERROR("sendDataToNonBlocking (fd: @#1)", _fd);
+		}
+		return size;
+	}
+
+	bool SocketAttr::enableZeroCopy() {
+		const int val = 1;
+		if (::setsockopt(_fd, SOL_SOCKET, SO_ZEROCOPY, &val, sizeof(val)) == -1) {
+			SI_LOG_PERROR("SO_ZEROCOPY (fd: @#1)", _fd);
+			return false;
+		}
+		return true;
+	}
+
+	int SocketAttr::readZeroCopyCompletion(uint32_t &begin, uint32_t &end, bool &copied) {
+		char control[CMSG_SPACE(sizeof(sock_extended_err)) * 2];
+		// Skip other messages on the error queue, until we find a completion
+		for (;;) {
+			msghdr msg{};
+			msg.msg_control = control;
+			msg.msg_controllen = sizeof(control);
+			if (::recvmsg(_fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) == -1) {
+				if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+					return 0;
+				}
+				SI_LOG_PERROR("MSG_ERRQUEUE (fd: @#1)", _fd);
+				return -1;
+			}
+			for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+				if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+					!(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)) {
+					continue;
+				}
+				sock_extended_err err;
+				std::memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+				if (err.ee_errno != 0 || err.ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+					continue;
+				}
+				begin = err.ee_info;
+				end = err.ee_data;
+				copied = (err.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0;
+				return 1;
+			}
+		}
+	}
+
+	int SocketAttr::sendMultipleDataToNonBlocking(const iovec *iov, const int iovcnt,
+			std::size_t count) {
+		count = std::min(count, MAX_SEND_DATAGRAMS);
+		mmsghdr msgs[MAX_SEND_DATAGRAMS];
+		for (std::size_t i = 0; i < count; ++i) {
+			msgs[i] = mmsghdr{};
+			msgs[i].msg_hdr.msg_name = &_addr;
+			msgs[i].msg_hdr.msg_namelen = sizeof(_addr);
+			msgs[i].msg_hdr.msg_iov = const_cast<iovec *>(iov + (i * iovcnt));
+			msgs[i].msg_hdr.msg_iovlen = iovcnt;
+		}
+		const int sent = ::sendmmsg(_fd, msgs, count, MSG_DONTWAIT);
+		if (sent == -1) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+				return 0;
+			}
+			SI_LOG_PERROR("sendmmsg (fd: @#1)", _fd);
+		}
+		return sent;
+	}
+
+	ssize_t SocketAttr::sendSegmentedDataToNonBlocking(const iovec *iov, const int iovcnt,
+			const uint16_t segmentSize) {
+		char control[CMSG_SPACE(sizeof(uint16_t))] = {};
+		msghdr msg{};
+		msg.msg_name = &_addr;
+		msg.msg_namelen = sizeof(_addr);
+		msg.msg_iov = const_cast<iovec *>(iov);
+		msg.msg_iovlen = iovcnt;
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+		cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level = SOL_UDP;
+		cmsg->cmsg_type = UDP_SEGMENT;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+		std::memcpy(CMSG_DATA(cmsg), &segmentSize, sizeof(uint16_t));
+		const ssize_t size = ::sendmsg(_fd, &msg, MSG_DONTWAIT);
+		if (size == -1 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+			return 0;
+		}
+		return size;
+	}
+
 	ssize_t SocketAttr::recvDatafrom(void *buf, std::size_t len, int flags) {
 		struct sockaddr_in si_other;
 		socklen_t addrlen = sizeof(si_other);
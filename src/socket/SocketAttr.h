@@ -23,6 +23,8 @@
 #include <FwDecl.h>
 #include <base/Mutex.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <string_view>
 
@@ -84,6 +86,49 @@ class SocketAttr {
 		/// connection-mode (SOCK_STREAM)
 		bool sendDataTo(const void* buf, std::size_t len, int flags);
 
+		/// Use this function when the socket is on a
+		/// connection-mode (SOCK_STREAM), and the data is scattered
+		bool sendDataTo(const struct iovec* iov, int iovcnt, int flags);
+
+		/// Write data without blocking when the socket is in connected state
+		/// @param zeroCopy specifies to send with MSG_ZEROCOPY, @see enableZeroCopy
+		/// @return the amount of bytes written, 0 when the socket would block
+		/// and -1 on an error
+		ssize_t writeDataNonBlocking(const struct iovec* iov, int iovcnt, bool zeroCopy = false);
+
+		/// Enable zero copy transmit (SO_ZEROCOPY) for this socket
+		bool enableZeroCopy();
+
+		/// Read one zero copy completion from the error queue of this socket.
+		/// The send calls with MSG_ZEROCOPY are numbered from 0.
+		/// @param begin specifies the first completed send call
+		/// @param end specifies the last completed send call
+		/// @param copied is set when the kernel did copy the data anyway
+		/// @return 1 when a completion was read, 0 when there is none and -1 on an error
+		int readZeroCopyCompletion(uint32_t& begin, uint32_t& end, bool& copied);
+
+		/// Same as @see writeDataNonBlocking, but sending to the address of
+		/// this socket, like @see sendDataTo
+		ssize_t sendDataToNonBlocking(const struct iovec* iov, int iovcnt);
+
+		/// Send several datagrams with one call to the address of this socket,
+		/// without blocking
+		/// @param iov specifies @p iovcnt iovec for each datagram
+		/// @param iovcnt specifies the amount of iovec of one datagram
+		/// @param count specifies the amount of datagrams, maximal MAX_SEND_DATAGRAMS
+		/// @return the amount of datagrams send, 0 when the socket would block
+		/// and -1 on an error
+		int sendMultipleDataToNonBlocking(const struct iovec* iov, int iovcnt, std::size_t count);
+
+		/// Send one large buffer to the address of this socket, that the kernel
+		/// splits in datagrams of @p segmentSize (UDP_SEGMENT). Only the last
+		/// datagram may be smaller. This function does not log errors, so the
+		/// caller can check errno if segmentation is supported.
+		/// @return the amount of bytes send, 0 when the socket would block
+		/// and -1 on an error
+		ssize_t sendSegmentedDataToNonBlocking(const struct iovec* iov, int iovcnt,
+			uint16_t segmentSize);
+
 		/// Get the port of this Socket
 		int getSocketPort() const;
 
@@ -137,6 +182,14 @@ class SocketAttr {
 		// =========================================================================
 		//  -- Data members --------------------------------------------------------
 		// =========================================================================
+	public:
+
+		/// The maximum amount of datagrams for one send call
+		static constexpr std::size_t MAX_SEND_DATAGRAMS = 64;
+
+		/// The maximum size of an UDP payload, when sending segmented data
+		static constexpr std::size_t MAX_UDP_PAYLOAD = 65507;
+
 	protected:
 
 		base::Mutex _mutex;
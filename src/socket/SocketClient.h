@@ -23,6 +23,8 @@
 #include <HeaderVector.h>
 #include <StringConverter.h>
 #include <TransportParamVector.h>
+#include <socket/HttpcParser.h>
+#include <socket/HttpcRequest.h>
 #include <socket/SocketAttr.h>
 
 #include <string>
@@ -36,7 +38,9 @@ class SocketClient :
 	public:
 
 		SocketClient() :
-			_protocolString("None") {}
+			_protocolString("None"),
+			_held(false),
+			_closeWhenReleased(false) {}
 
 		virtual ~SocketClient() = default;
 
@@ -49,6 +53,8 @@ class SocketClient :
 		virtual void closeFD() final {
 			SocketAttr::closeFD();
 			_msg.clear();
+			_request.clear();
+			_parser.clear();
 		}
 
 		// =========================================================================
@@ -59,21 +65,48 @@ class SocketClient :
 		/// Clear the HTTP message
 		void clearMessage() {
 			_msg.clear();
+			_request.clear();
 		}
 
 		/// Add HTTP message data
 		/// @param msg specifies the message to set/add
 		void addMessage(const std::string &msg) {
 			_msg += msg;
+			_request.parse(_msg);
+		}
+
+		/// Add received data, it becomes the HTTP message when it is complete
+		void addReceivedData(const char *data, std::size_t size) {
+			_parser.addData(data, size);
+		}
+
+		/// Make the next complete received message the HTTP message
+		/// @return true if there was a complete message
+		bool nextMessage() {
+			if (!_parser.nextMessage(_msg)) {
+				return false;
+			}
+			_request.parse(_msg);
+			return true;
+		}
+
+		/// Check if the received data can not be a valid HTTP message
+		bool hasInvalidMessage() const {
+			return _parser.hasError();
+		}
+
+		/// Get the parsed HTTP message
+		const HttpcRequest &getRequest() const {
+			return _request;
 		}
 
 		/// Get the Headers of the HTTP message
-		HeaderVector getHeaders() const {
-			return HeaderVector(StringConverter::split(_msg, "\r\n"));
+		const HeaderVector &getHeaders() const {
+			return _request.getHeaders();
 		}
 
 		/// Get the Raw HTTP message data
-		std::string getRawMessage() const {
+		const std::string &getRawMessage() const {
 			return _msg;
 		}
 
@@ -83,81 +116,38 @@ class SocketClient :
 			const std::string::size_type n = _msg.find("\r\n\r\n");
 			if (n != std::string::npos) {
 				_msg.insert(n + 2, header);
+				_request.parse(_msg);
 			}
 		}
 
 		/// Get the Method used for this HTTP message
-		std::string getMethod() const {
-			// request line should be in the first line (method)
-			HeaderVector headers = getHeaders();
-			const std::string& line = headers[0];
-			if (!headers[0].empty()) {
-				std::string::const_iterator it = line.begin();
-				// remove any leading whitespace
-				while (*it == ' ') ++it;
-
-				// copy method (upper case)
-				std::string method;
-				while (*it != ' ') {
-					method += std::toupper(*it);
-					++it;
-				}
-				return method;
-			}
-			return std::string();
+		const std::string &getMethod() const {
+			return _request.getMethod();
 		}
 
 		/// Get the content from HTTP message
 		std::string getContentFrom() const {
-			HeaderVector headers = getHeaders();
-			const std::string p = headers.getFieldParameter("Content-Length");
-			const std::size_t contentLength = (!p.empty() && std::isdigit(p[0])) ? std::stoi(p) : 0;
-			if (contentLength > 0) {
-				const std::string::size_type headerSize = _msg.find("\r\n\r\n", 0);
-				if (headerSize != std::string::npos) {
-					return _msg.substr(headerSize + 4);
-				}
-			}
-			return std::string();
+			return std::string(_request.getContent());
 		}
 
 		/// Get the requested resource from HTTP message
 		std::string getRequestedFile() const {
-			HeaderVector headers = getHeaders();
-			const std::string& param = headers[0];
-			if (!param.empty()) {
-				const std::string::size_type begin = param.find_first_of("/");
-				const std::string::size_type end   = param.find_first_of(" ", begin);
-				return param.substr(begin, end - begin);
-			}
-			return std::string();
+			return std::string(_request.getURI());
 		}
 
 		/// Is the request the root-resource
 		bool isRootFile() const {
-			return _msg.find("/ ") != std::string::npos;
+			return _request.getURI() == "/";
 		}
 
 		/// Does the request have any Transport Parameters
 		bool hasTransportParameters() const {
-			// Transport Parameters should be in the first line (method)
-			std::string::size_type nextline = 0;
-			const std::string line = StringConverter::getline(_msg, nextline, "\r\n");
-			if (!line.empty()) {
-				const std::string::size_type size = line.size() - 1;
-				const std::string::size_type found = line.find_first_of("?");
-				if (found != std::string::npos && found < size && line[found + 1] != ' ') {
-					return true;
-				}
-			}
-			return false;
+			return _request.hasQuery();
 		}
 
 		/// Get the Transport Parameters
-		TransportParamVector getTransportParameters() const {
-			HeaderVector headers = getHeaders();
-			return TransportParamVector(StringConverter::split(
-				StringConverter::getPercentDecoding(headers[0]), " /?&"));
+		const TransportParamVector &getTransportParameters() const {
+			return _request.getTransportParameters();
 		}
 
 		/// Get the Percent Decoded HTTP message from this client
@@ -167,17 +157,33 @@ class SocketClient :
 
 		/// Get the protocol specified in this HTTP message
 		std::string getProtocol() const {
-			// Protocol should be in the first line
-			std::string::size_type nextline = 0;
-			const std::string line = StringConverter::getline(_msg, nextline, "\r\n");
-			if (!line.empty()) {
-				const std::string::size_type begin = line.find_last_of(" ") + 1;
-				const std::string::size_type end   = line.find_last_of("/");
-				if (begin != std::string::npos && end != std::string::npos) {
-					return line.substr(begin, end - begin);
-				}
-			}
-			return std::string();
+			return std::string(_request.getProtocol());
+		}
+
+		/// Hold the next messages of this client, because the current one is
+		/// handled by an other thread
+		void hold() {
+			_held = true;
+		}
+
+		/// Release this client, so its next messages can be handled
+		void release() {
+			_held = false;
+		}
+
+		/// Check if the next messages of this client are held
+		bool isHeld() const {
+			return _held;
+		}
+
+		/// Close the connection of this client when it is released
+		void setCloseWhenReleased(const bool close) {
+			_closeWhenReleased = close;
+		}
+
+		/// Check if the connection should be closed when it is released
+		bool isCloseWhenReleased() const {
+			return _closeWhenReleased;
 		}
 
 		/// Set protocol string
@@ -197,7 +203,11 @@ class SocketClient :
 	private:
 
 		mutable std::string _msg;
+		mutable HttpcRequest _request;
+		HttpcParser _parser;
 		std::string _protocolString;
+		bool _held;
+		bool _closeWhenReleased;
 };
 
 #endif
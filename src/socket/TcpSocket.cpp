@@ -23,11 +23,16 @@
 #include <Log.h>
 #include <Utils.h>
 
+#include <cerrno>
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
 
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
 
@@ -36,19 +41,24 @@
 // =============================================================================
 
 TcpSocket::TcpSocket(int maxClients, const std::string &protocol) :
-		_MAX_CLIENTS(maxClients),
-		_MAX_POLL(maxClients + 1),
-		_pfd(new pollfd[maxClients + 1]),
-		_client(new SocketClient[maxClients]),
+		_maxClients(maxClients),
+		_epollFD(-1),
+		_acceptAll(false),
+		_connections(0),
+		_releaseFD(-1),
 		_protocolString(protocol) {}
 
 TcpSocket::~TcpSocket() {
 	_server.closeFD();
-	for (std::size_t j = 0; j < _MAX_CLIENTS; ++j) {
-		_client[j].closeFD();
+	for (const std::unique_ptr<SocketClient> &client : _client) {
+		client->closeFD();
+	}
+	if (_epollFD != -1) {
+		::close(_epollFD);
+	}
+	if (_releaseFD != -1) {
+		::close(_releaseFD);
 	}
-	DELETE_ARRAY(_pfd);
-	DELETE_ARRAY(_client);
 }
 
 // =============================================================================
@@ -56,68 +66,200 @@ TcpSocket::~TcpSocket() {
 // =============================================================================
 
 void TcpSocket::initialize(const std::string &ipAddr, int port, bool nonblock) {
-	for (std::size_t i = 0; i < _MAX_CLIENTS; ++i) {
-		_client[i].setProtocol(_protocolString);
-	}
-	if (initServerSocket(ipAddr, port, _MAX_CLIENTS, nonblock)) {
-		_pfd[0].fd = _server.getFD();
-		_pfd[0].events = POLLIN | POLLHUP | POLLRDNORM | POLLERR;
-		_pfd[0].revents = 0;
-
-		for (std::size_t i = 1; i < _MAX_POLL; ++i) {
-			_pfd[i].fd = -1;
-			_pfd[i].events = POLLIN | POLLHUP | POLLRDNORM | POLLERR;
-			_pfd[i].revents = 0;
+	_epollFD = ::epoll_create1(EPOLL_CLOEXEC);
+	if (_epollFD == -1) {
+		SI_LOG_PERROR("@#1: epoll_create1", _protocolString);
+		return;
+	}
+	if (initServerSocket(ipAddr, port, _maxClients, nonblock)) {
+		// Edge-triggered, so accept until there is no connection left.
+		// The server is the only one without a client pointer
+		epoll_event ev{};
+		ev.events = EPOLLIN;
+		if (nonblock) {
+			ev.events |= EPOLLET;
+		}
+		ev.data.ptr = nullptr;
+		_acceptAll = nonblock;
+		if (::epoll_ctl(_epollFD, EPOLL_CTL_ADD, _server.getFD(), &ev) == -1) {
+			SI_LOG_PERROR("@#1: epoll_ctl server", _protocolString);
+		}
+	}
+	// The release event has this socket as pointer
+	_releaseFD = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (_releaseFD != -1) {
+		epoll_event ev{};
+		ev.events = EPOLLIN;
+		ev.data.ptr = this;
+		if (::epoll_ctl(_epollFD, EPOLL_CTL_ADD, _releaseFD, &ev) == -1) {
+			SI_LOG_PERROR("@#1: epoll_ctl release", _protocolString);
+			::close(_releaseFD);
+			_releaseFD = -1;
 		}
+	} else {
+		SI_LOG_PERROR("@#1: eventfd", _protocolString);
 	}
 }
 
 int TcpSocket::poll(int timeout) {
-	if (::poll(_pfd, _MAX_POLL, timeout) > 0) {
-		// Check who is sending data, so iterate over pfd
-		for (std::size_t i = 0; i < _MAX_POLL; ++i) {
-			if (_pfd[i].revents == 0) {
-				continue;
+	if (_epollFD == -1) {
+		::poll(nullptr, 0, timeout);
+		return 1;
+	}
+	epoll_event events[MAX_EVENTS];
+	const int n = ::epoll_wait(_epollFD, events, MAX_EVENTS, timeout);
+	for (int i = 0; i < n; ++i) {
+		if (events[i].data.ptr == nullptr) {
+			acceptConnections();
+		} else if (events[i].data.ptr == this) {
+			handleReleasedClients();
+		} else {
+			SocketClient *client = static_cast<SocketClient *>(events[i].data.ptr);
+			handleClientEvents(*client, events[i].events);
+		}
+	}
+	return 1;
+}
+
+void TcpSocket::acceptConnections() {
+	for (;;) {
+		SocketClient *client = getFreeClient();
+		if (client == nullptr) {
+			// Connection limit reached, refuse it instead of leaving it
+			// waiting in the backlog
+			SocketClient refused;
+			refused.setProtocol(_protocolString);
+			if (!_server.acceptConnection(refused, false)) {
+				return;
 			}
-			// index 0 is server
-			if (i == 0) {
-				// Try to find a free poll entry
-				for (std::size_t j = 0; j < _MAX_CLIENTS; ++j) {
-					if (_pfd[j + 1].fd != -1) {
-						continue;
-					}
-					if (acceptConnection(_client[j], true)) {
-						// setup polling
-						_pfd[j + 1].fd = _client[j].getFD();
-						_pfd[j + 1].events = POLLIN | POLLHUP | POLLRDNORM | POLLERR;
-						_pfd[j + 1].revents = 0;
-						break;
-					}
-				}
-			} else {
-				// receive httpc messages
-				const auto dataSize = recvHttpcMessage(_client[i-1], MSG_DONTWAIT);
-				if (dataSize > 0) {
-					process(_client[i - 1]);
-					continue;
-				}
-				// Try to find the client that requested to close
-				for (std::size_t j = 0; j < _MAX_CLIENTS; ++j) {
-					if (_client[j].getFD() != _pfd[i].fd) {
-						continue;
-					}
-					SI_LOG_INFO("@#1 Client @#2:@#3 Connection closed with fd: @#4",
-						_client[j].getProtocolString(),
-						_client[j].getIPAddressOfSocket(),
-						_client[j].getSocketPort(), _client[j].getFD());
-					_client[j].closeFD();
-					break;
-				}
-				_pfd[i].fd = -1;
+			SI_LOG_ERROR("@#1 Connection from @#2 refused, limit of @#3 connections reached",
+				_protocolString, refused.getIPAddressOfSocket(), _maxClients);
+			refused.closeFD();
+			if (!_acceptAll) {
+				return;
 			}
+			continue;
+		}
+		if (!_server.acceptConnection(*client, true)) {
+			_freeClient.push_front(client);
+			return;
+		}
+		epoll_event ev{};
+		ev.events = EPOLLIN | EPOLLET;
+		ev.data.ptr = client;
+		if (::epoll_ctl(_epollFD, EPOLL_CTL_ADD, client->getFD(), &ev) == -1) {
+			SI_LOG_PERROR("@#1: epoll_ctl client", _protocolString);
+			client->closeFD();
+			_freeClient.push_front(client);
+			continue;
+		}
+		++_connections;
+		if (!_acceptAll) {
+			return;
 		}
 	}
-	return 1;
+}
+
+void TcpSocket::handleClientEvents(SocketClient &client, const uint32_t events) {
+	if ((events & EPOLLIN) != 0) {
+		// receive httpc messages, a partial message waits for more data
+		const auto dataSize = recvHttpcMessage(client, MSG_DONTWAIT);
+		const bool wouldBlock = dataSize == -1 && (errno == EAGAIN || errno == EWOULDBLOCK);
+		if (processMessages(client) && (dataSize > 0 || wouldBlock)) {
+			return;
+		}
+	} else if ((events & EPOLLHUP) == 0) {
+		// Only EPOLLERR, check it is a real error and not for instance
+		// a zero copy completion that is in the error queue
+		int error = 0;
+		socklen_t len = sizeof(error);
+		if (::getsockopt(client.getFD(), SOL_SOCKET, SO_ERROR, &error, &len) == 0 && error == 0) {
+			return;
+		}
+	}
+	closeConnection(client);
+}
+
+bool TcpSocket::processMessages(SocketClient &client) {
+	// A held client keeps its next messages until it is released
+	while (client.getFD() != -1 && !client.isHeld() && client.nextMessage()) {
+		process(client);
+	}
+	if (client.hasInvalidMessage()) {
+		SI_LOG_ERROR("@#1 Client @#2:@#3 Invalid or too big message",
+			client.getProtocolString(), client.getIPAddressOfSocket(), client.getSocketPort());
+		return false;
+	}
+	return true;
+}
+
+bool TcpSocket::holdClient(SocketClient &client) {
+	if (_releaseFD == -1) {
+		return false;
+	}
+	client.hold();
+	return true;
+}
+
+void TcpSocket::releaseClient(SocketClient &client) {
+	{
+		std::lock_guard<std::mutex> lock(_releaseMutex);
+		_released.push_back(&client);
+	}
+	const uint64_t value = 1;
+	if (::write(_releaseFD, &value, sizeof(value)) == -1) {
+		SI_LOG_PERROR("@#1: Release client", _protocolString);
+	}
+}
+
+void TcpSocket::handleReleasedClients() {
+	uint64_t value;
+	if (::read(_releaseFD, &value, sizeof(value)) == -1) {
+		return;
+	}
+	std::vector<SocketClient *> released;
+	{
+		std::lock_guard<std::mutex> lock(_releaseMutex);
+		released.swap(_released);
+	}
+	for (SocketClient *client : released) {
+		client->release();
+		if (client->isCloseWhenReleased() || !processMessages(*client)) {
+			closeConnection(*client);
+		}
+	}
+}
+
+void TcpSocket::closeConnection(SocketClient &client) {
+	if (client.isHeld()) {
+		// An other thread is still handling its request
+		client.setCloseWhenReleased(true);
+		return;
+	}
+	client.setCloseWhenReleased(false);
+	SI_LOG_INFO("@#1 Client @#2:@#3 Connection closed with fd: @#4",
+		client.getProtocolString(), client.getIPAddressOfSocket(),
+		client.getSocketPort(), client.getFD());
+	::epoll_ctl(_epollFD, EPOLL_CTL_DEL, client.getFD(), nullptr);
+	client.closeFD();
+	// Reuse the oldest closed client first, a StreamClient can still be
+	// looking at this one
+	_freeClient.push_back(&client);
+	--_connections;
+}
+
+SocketClient *TcpSocket::getFreeClient() {
+	if (_connections >= _maxClients) {
+		return nullptr;
+	}
+	if (_freeClient.empty()) {
+		_client.push_back(std::make_unique<SocketClient>());
+		_client.back()->setProtocol(_protocolString);
+		return _client.back().get();
+	}
+	SocketClient *client = _freeClient.front();
+	_freeClient.pop_front();
+	return client;
 }
 
 bool TcpSocket::initServerSocket(
@@ -145,8 +287,3 @@ bool TcpSocket::initServerSocket(
 	}
 	return true;
 }
-
-bool TcpSocket::acceptConnection(SocketClient &client, bool showLogInfo) {
-	// check if we have a client?
-	return _server.acceptConnection(client, showLogInfo);
-}
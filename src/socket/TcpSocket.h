@@ -24,11 +24,17 @@
 #include <socket/HttpcSocket.h>
 #include <socket/SocketAttr.h>
 
-#include <poll.h>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 FW_DECL_NS0(SocketClient);
 
-/// TCP Socket
+/// TCP Socket server, the connections are handled with epoll so the amount
+/// of connections only costs memory, up until the connection limit
 class TcpSocket :
 	public HttpcSocket {
 		// =====================================================================
@@ -37,6 +43,7 @@ class TcpSocket :
 
 	public:
 
+		/// @param maxClients specifies the maximum amount of connections
 		TcpSocket(int maxClients, const std::string &protocol);
 
 		virtual ~TcpSocket();
@@ -48,7 +55,7 @@ class TcpSocket :
 	public:
 
 		/// Call this function periodically to check for messages
-		/// @param timeout specifies the timeout 'poll' should use
+		/// @param timeout specifies the timeout 'epoll_wait' should use
 		int poll(int timeout);
 
 	protected:
@@ -60,6 +67,15 @@ class TcpSocket :
 		/// @param client specifies the client that sended the message etc.
 		virtual bool process(SocketClient &client) = 0;
 
+		/// Hold the next messages of this client, so its current message can be
+		/// handled by an other thread. That thread should call @see releaseClient
+		/// and it should be stopped before this socket is destroyed
+		/// @return false if the client can not be held, then handle it directly
+		bool holdClient(SocketClient &client);
+
+		/// Release the held client, this can be called from any thread
+		void releaseClient(SocketClient &client);
+
 		/// Get the protocol string
 		const std::string &getProtocolString() const {
 			return _protocolString;
@@ -74,8 +90,25 @@ class TcpSocket :
 			int maxClients,
 			bool nonblock);
 
-		/// Accept an connection and save client IP address etc.
-		bool acceptConnection(SocketClient &client, bool showLogInfo);
+		/// Accept all waiting connections, the listen socket is edge-triggered
+		void acceptConnections();
+
+		/// Handle the events of an accepted connection
+		void handleClientEvents(SocketClient &client, uint32_t events);
+
+		/// Handle the complete messages of this client, until it is held
+		/// @return false if the client sended an invalid message
+		bool processMessages(SocketClient &client);
+
+		/// Handle the next messages of the released clients
+		void handleReleasedClients();
+
+		/// Close the connection and make its client free again
+		void closeConnection(SocketClient &client);
+
+		/// Get a free client, or make a new one when there is none
+		/// @return nullptr when the connection limit is reached
+		SocketClient *getFreeClient();
 
 		// =====================================================================
 		// -- Data members -----------------------------------------------------
@@ -83,11 +116,23 @@ class TcpSocket :
 
 	private:
 
-		std::size_t        _MAX_CLIENTS;   //
-		std::size_t        _MAX_POLL;      //
-		struct pollfd     *_pfd;           //
+		/// Maximum amount of events handled per epoll_wait
+		static constexpr int MAX_EVENTS = 64;
+
+		std::size_t        _maxClients;    //
+		int                _epollFD;       //
+		bool               _acceptAll;     //
 		SocketAttr         _server;        //
-		SocketClient      *_client;        //
+		/// All clients, they are never deleted, because a @c StreamClient can
+		/// still use it to see that its connection is closed
+		std::vector<std::unique_ptr<SocketClient>> _client;
+		/// The closed clients, oldest first
+		std::deque<SocketClient *> _freeClient;
+		std::size_t        _connections;   //
+		/// Event to wakeup epoll_wait, when a held client is released
+		int                _releaseFD;
+		std::mutex         _releaseMutex;
+		std::vector<SocketClient *> _released;
 		const std::string  _protocolString;//
 
 };
@@ -166,7 +166,7 @@ void Server::checkReply(
 	// save client ip address
 	const std::string ipAddress = inet_ntoa(si_other.sin_addr);
 
-	HeaderVector headers = udpMultiListen.getHeaders();
+	const HeaderVector &headers = udpMultiListen.getHeaders();
 
 	// @TODO we should probably listen to only one message
 	// check do we hear our echo, same UUID
@@ -176,7 +176,7 @@ void Server::checkReply(
 	}
 
 	// get method from message
-	const std::string method = udpMultiListen.getMethod();
+	const std::string &method = udpMultiListen.getMethod();
 	if (!method.empty()) {
 		const std::string deviceID = headers.getFieldParameter("DEVICEID.SES.COM");
 		const std::string st = headers.getFieldParameter("ST");